@@ -0,0 +1,213 @@
+/* Batched lookups against their one-at-a-time counterparts:
+ *
+ *   - agc_u64vec_gather against a loop of agc_u64vec_ptr_at
+ *   - agc_u64vec_scatter_add against a loop of +=
+ *   - agc_intern_find_many against a loop of agc_intern_find, both on one
+ *     thread, then find_many again on every OpenMP thread
+ *
+ * Indices and strings are random, so nearly every access misses the
+ * cache once the vector is much larger than the last level cache.
+ *
+ *     cc -std=c23 -O2 -fopenmp -Isrc bench/gather.c src/intern.c src/error.c -o gather
+ *     ./gather [log2 vector length] [log2 lookups]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+#include "intern.h"
+#include "vectors.h"
+
+static f64
+now(void)
+{
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (f64)ts.tv_sec + (f64)ts.tv_nsec * 1e-9;
+}
+
+static u64
+xorshift(u64 state[static 1])
+{
+	u64 x = *state;
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return *state = x;
+}
+
+static void
+report(char const *what, f64 naive, f64 batched)
+{
+	printf("%-12s naive %8.3f s   batched %8.3f s   speedup %.2fx\n",
+	       what,
+	       naive,
+	       batched,
+	       naive / batched);
+}
+
+static agc_err_t
+bench_vector(u32 log_len, u32 log_n)
+{
+	int32_t      len  = (int32_t)1 << log_len;
+	int32_t      n    = (int32_t)1 << log_n;
+	agc_u64vec_t vec  = { };
+	agc_u64vec_t out  = { };
+	agc_u64vec_t ones = { };
+	u32         *idx  = malloc(sizeof(u32) * (size_t)n);
+	u64          seed = 88172645463325252ull;
+
+	agc_err_t err = idx ? AGC_OK : AGC_ERR_MEMORY;
+	if (!err) err = agc_u64vec_init(&vec, len);
+	if (!err) err = agc_u64vec_resize(&vec, len);
+	if (!err) err = agc_u64vec_init(&ones, n);
+	if (!err) err = agc_u64vec_resize(&ones, n);
+	if (!err) err = agc_u64vec_init(&out, n);
+	if (!err) err = agc_u64vec_resize(&out, n);
+	if (err) goto out;
+
+	for (int32_t i = 0; i < len; i++)
+		vec.buf[i] = (u64)i * 3;
+	for (int32_t i = 0; i < n; i++)
+	{
+		idx[i]      = (u32)(xorshift(&seed) % (u64)len);
+		ones.buf[i] = 1;
+	}
+
+	/* Both write to the already touched out, so neither pays its page faults */
+	f64 t0 = now();
+	for (int32_t i = 0; i < n; i++)
+		out.buf[i] = *agc_u64vec_ptr_at(&vec, (int32_t)idx[i]);
+	f64 t1  = now();
+	u64 sum = 0;
+	for (int32_t i = 0; i < n; i++)
+		sum += out.buf[i];
+
+	f64 t2 = now();
+	err    = agc_u64vec_gather(&vec, idx, n, &out);
+	f64 t3 = now();
+	if (err) goto out;
+
+	for (int32_t i = 0; i < n; i++)
+		sum -= out.buf[i];
+	report("gather", t1 - t0, t3 - t2);
+
+	t0 = now();
+	for (int32_t i = 0; i < n; i++)
+		vec.buf[idx[i]] += ones.buf[i];
+	t1  = now();
+	err = agc_u64vec_scatter_add(&vec, idx, ones.buf, n);
+	t2  = now();
+	if (err) goto out;
+
+	report("scatter_add", t1 - t0, t2 - t1);
+	if (sum != 0) err = AGC_ERR_INVALID;
+
+out:
+	free(idx);
+	agc_u64vec_cleanup(&vec);
+	agc_u64vec_cleanup(&out);
+	agc_u64vec_cleanup(&ones);
+	return err;
+}
+
+static agc_err_t
+bench_intern(u32 log_n)
+{
+	u32            n     = 1u << log_n;
+	agc_intern_t   table = { };
+	agc_u32vec_t   ids   = { };
+	char          *chars = malloc((size_t)n * 24);
+	agc_strview_t *strs  = malloc(sizeof(agc_strview_t) * n);
+	u32           *query = malloc(sizeof(u32) * n);
+	agc_strview_t *order = malloc(sizeof(agc_strview_t) * n);
+	u64            seed  = 2463534242ull;
+
+	agc_err_t err = chars && strs && query && order ? AGC_OK : AGC_ERR_MEMORY;
+	if (!err) err = agc_intern_init(&table, n);
+	if (err) goto out;
+
+	for (u32 i = 0; i < n; i++)
+	{
+		int size = snprintf(chars + (size_t)i * 24, 24, "vertex-%u", i);
+		strs[i]  = (agc_strview_t){ .ptr = chars + (size_t)i * 24, .len = (u32)size };
+		query[i] = 0;
+		err      = agc_intern(&table, strs[i], &query[i]);
+		if (err) goto out;
+	}
+	for (u32 i = 0; i < n; i++)
+		order[i] = strs[xorshift(&seed) % n];
+
+	f64 t0   = now();
+	u32 hits = 0;
+	for (u32 i = 0; i < n; i++)
+		hits += agc_intern_find(&table, order[i], &query[i]) == AGC_OK;
+	f64 t1 = now();
+
+	/* The naive loop runs on one thread, so find_many does too, and then
+	 * once more on all of them */
+#ifdef _OPENMP
+	int n_threads = omp_get_max_threads();
+	omp_set_num_threads(1);
+#endif
+	err    = agc_intern_find_many(&table, order, n, &ids);
+	f64 t2 = now();
+#ifdef _OPENMP
+	omp_set_num_threads(n_threads);
+#endif
+	if (err) goto out;
+	report("find_many", t1 - t0, t2 - t1);
+
+#ifdef _OPENMP
+	agc_u32vec_cleanup(&ids);
+	f64 t3 = now();
+	err    = agc_intern_find_many(&table, order, n, &ids);
+	f64 t4 = now();
+	if (err) goto out;
+
+	char what[32];
+	snprintf(what, sizeof(what), "  %d threads", n_threads);
+	report(what, t1 - t0, t4 - t3);
+#endif
+
+	if (hits != n) err = AGC_ERR_INVALID;
+	for (u32 i = 0; i < n && !err; i++)
+	{
+		if (ids.buf[i] != query[i]) err = AGC_ERR_INVALID;
+	}
+
+out:
+	agc_u32vec_cleanup(&ids);
+	agc_intern_cleanup(&table);
+	free(chars);
+	free(strs);
+	free(query);
+	free(order);
+	return err;
+}
+
+int
+main(int argc, char **argv)
+{
+	u32 log_len = argc > 1 ? (u32)atoi(argv[1]) : 26;
+	u32 log_n   = argc > 2 ? (u32)atoi(argv[2]) : 24;
+	if (log_len < 1 || log_len > 30 || log_n < 1 || log_n > 30)
+	{
+		fprintf(stderr, "usage: %s [log2 vector length] [log2 lookups]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	agc_err_t err = bench_vector(log_len, log_n);
+	if (!err) err = bench_intern(agc_min(log_n, 22));
+	if (err)
+	{
+		agc_write_error(err, stderr);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
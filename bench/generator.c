@@ -0,0 +1,182 @@
+/* Generator throughput in edges per second, then TEPS (traversed edges
+ * per second) of the graph kernels on the symmetrised R-MAT graph:
+ *
+ *   - agc_gen_rmat, agc_gen_erdos_renyi, agc_gen_grid_2d, agc_gen_grid_3d
+ *   - agc_bfs and agc_sssp_delta_stepping from a few sources, counting
+ *     the arcs of the vertices they reach, as Graph500 does
+ *   - agc_cc_afforest, counting every arc
+ *
+ * There is no PageRank kernel in the tree yet, so it is not measured.
+ *
+ *     cc -std=c23 -O2 -fopenmp -Isrc bench/generator.c src/[a-z]*.c -o generator
+ *     ./generator [scale] [edge factor]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "bfs.h"
+#include "components.h"
+#include "generator.h"
+#include "sssp.h"
+
+#define BENCH_SEED 20240611ull
+#define BENCH_SOURCES 8
+#define BENCH_MAX_WEIGHT 255
+#define BENCH_DELTA 32
+
+static f64
+now(void)
+{
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (f64)ts.tv_sec + (f64)ts.tv_nsec * 1e-9;
+}
+
+static void
+report(char const *what, u64 n_edges, f64 seconds, char const *unit)
+{
+	printf("%-14s %12llu edges %8.3f s %10.1f M%s\n",
+	       what,
+	       (unsigned long long)n_edges,
+	       seconds,
+	       (f64)n_edges / seconds * 1e-6,
+	       unit);
+}
+
+/* Arcs out of the vertices with reached[v] != unreached */
+static u64
+reached_arcs(const agc_csr_t g[static 1], const agc_u32vec_t reached[static 1], u32 unreached)
+{
+	u64 arcs = 0;
+	for (u32 v = 0; v < g->n_vertices; v++)
+	{
+		if (reached->buf[v] != unreached) arcs += agc_csr_degree(g, v);
+	}
+	return arcs;
+}
+
+static agc_err_t
+bench_generators(u32 scale, u32 edge_factor, agc_edgevec_t OUT_rmat[static 1])
+{
+	agc_edgevec_t edges = { };
+	u32           n     = 1u << scale;
+	u32           side  = 1u << (scale / 2);
+	u32           cube  = 1u << (scale / 3);
+
+	f64       t0  = now();
+	agc_err_t err = agc_gen_rmat(OUT_rmat, scale, edge_factor, AGC_RMAT_GRAPH500, BENCH_SEED,
+	                             BENCH_MAX_WEIGHT);
+	if (err) return err;
+	report("rmat", (u64)OUT_rmat->len, now() - t0, "edges/s");
+
+	t0  = now();
+	err = agc_gen_erdos_renyi(&edges, n, (u32)OUT_rmat->len, BENCH_SEED, BENCH_MAX_WEIGHT);
+	if (err) return err;
+	report("erdos_renyi", (u64)edges.len, now() - t0, "edges/s");
+	agc_edgevec_cleanup(&edges);
+
+	t0  = now();
+	err = agc_gen_grid_2d(&edges, side, n / side, BENCH_SEED, BENCH_MAX_WEIGHT);
+	if (err) return err;
+	report("grid_2d", (u64)edges.len, now() - t0, "edges/s");
+	agc_edgevec_cleanup(&edges);
+
+	t0  = now();
+	err = agc_gen_grid_3d(&edges, cube, cube, n / cube / cube, BENCH_SEED, BENCH_MAX_WEIGHT);
+	if (err) return err;
+	report("grid_3d", (u64)edges.len, now() - t0, "edges/s");
+	agc_edgevec_cleanup(&edges);
+
+	return AGC_OK;
+}
+
+static agc_err_t
+bench_kernels(const agc_csr_t g[static 1])
+{
+	agc_u32vec_t out   = { };
+	agc_u32vec_t sizes = { };
+	u64          arcs  = 0;
+	f64          spent = 0;
+	agc_err_t    err   = AGC_OK;
+
+	/* Sources spread over the id range, skipping isolated vertices */
+	u32 sources[BENCH_SOURCES];
+	u32 n_sources = 0;
+	for (u32 v = 0; v < g->n_vertices && n_sources < BENCH_SOURCES; v += g->n_vertices / 64 + 1)
+	{
+		if (agc_csr_degree(g, v) > 0) sources[n_sources++] = v;
+	}
+	if (n_sources == 0) return AGC_ERR_INVALID;
+
+	for (u32 i = 0; i < n_sources; i++)
+	{
+		f64 t0 = now();
+		err    = agc_bfs(g, nullptr, sources[i], &out);
+		spent += now() - t0;
+		if (err) return err;
+
+		arcs += reached_arcs(g, &out, AGC_BFS_NO_PARENT);
+		agc_u32vec_cleanup(&out);
+	}
+	report("bfs", arcs, spent, "TEPS");
+
+	arcs  = 0;
+	spent = 0;
+	for (u32 i = 0; i < n_sources; i++)
+	{
+		f64 t0 = now();
+		err    = agc_sssp_delta_stepping(g, sources[i], BENCH_DELTA, &out);
+		spent += now() - t0;
+		if (err) return err;
+
+		arcs += reached_arcs(g, &out, AGC_SSSP_INF);
+		agc_u32vec_cleanup(&out);
+	}
+	report("sssp_delta", arcs, spent, "TEPS");
+
+	f64 t0 = now();
+	err    = agc_cc_afforest(g, 0, &out, &sizes);
+	spent  = now() - t0;
+	if (err) return err;
+
+	report("cc_afforest", agc_csr_n_edges(g), spent, "TEPS");
+	agc_u32vec_cleanup(&out);
+	agc_u32vec_cleanup(&sizes);
+	return AGC_OK;
+}
+
+int
+main(int argc, char **argv)
+{
+	u32 scale       = argc > 1 ? (u32)atoi(argv[1]) : 22;
+	u32 edge_factor = argc > 2 ? (u32)atoi(argv[2]) : 16;
+	if (scale < 3 || scale > 26 || edge_factor < 1 || edge_factor > 64)
+	{
+		fprintf(stderr, "usage: %s [scale 3..26] [edge factor 1..64]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	agc_edgevec_t rmat = { };
+	agc_csr_t     g    = { };
+
+	agc_err_t err = bench_generators(scale, edge_factor, &rmat);
+	if (!err)
+	{
+		f64 t0 = now();
+		err    = agc_csr_from_edges(&g, 1u << scale, &rmat,
+		                            AGC_CSR_SYMMETRIZE | AGC_CSR_SIMPLE | AGC_CSR_WEIGHTED);
+		if (!err) report("csr", (u64)rmat.len, now() - t0, "edges/s");
+	}
+	agc_edgevec_cleanup(&rmat);
+	if (!err) err = bench_kernels(&g);
+	agc_csr_cleanup(&g);
+
+	if (err)
+	{
+		agc_write_error(err, stderr);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
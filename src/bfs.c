@@ -0,0 +1,75 @@
+#include <string.h>
+
+#include "bfs.h"
+#include "edge_map.h"
+
+static bool
+bfs_update_atomic(u32 src, u32 dst, void *ctx)
+{
+	u32 *parents  = ctx;
+	u32  expected = AGC_BFS_NO_PARENT;
+	return __atomic_compare_exchange_n(
+	        &parents[dst], &expected, src, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+static bool
+bfs_update(u32 src, u32 dst, void *ctx)
+{
+	u32 *parents = ctx;
+	parents[dst] = src;
+	return true;
+}
+
+static bool
+bfs_cond(u32 dst, void *ctx)
+{
+	const u32 *parents = ctx;
+	return __atomic_load_n(&parents[dst], __ATOMIC_RELAXED) == AGC_BFS_NO_PARENT;
+}
+
+agc_err_t
+agc_bfs(const agc_csr_t  g[static 1],
+        const agc_csr_t *g_in,
+        u32              source,
+        agc_u32vec_t     OUT_parents[static 1])
+{
+	if (!g || !OUT_parents) return AGC_ERR_NULL;
+	if (source >= g->n_vertices) return AGC_ERR_OOB;
+	agc_err_t err = AGC_OK;
+
+	err = agc_u32vec_init(OUT_parents, (int32_t)g->n_vertices);
+	if (err) return err;
+	err = agc_u32vec_resize(OUT_parents, (int32_t)g->n_vertices);
+	if (err) goto fail;
+
+	memset(OUT_parents->buf, 0xff, sizeof(u32) * g->n_vertices);
+	OUT_parents->buf[source] = source;
+
+	agc_edge_map_fns_t fns = {
+		.update_atomic = bfs_update_atomic,
+		.update        = bfs_update,
+		.cond          = bfs_cond,
+		.ctx           = OUT_parents->buf,
+	};
+
+	agc_vertex_subset_t frontier = { };
+
+	err = agc_vertex_subset_init_single(&frontier, g->n_vertices, source);
+	if (err) goto fail;
+
+	while (!agc_vertex_subset_empty(&frontier))
+	{
+		agc_vertex_subset_t next = { };
+		err                      = agc_edge_map(g, g_in, &frontier, &fns, &next);
+		agc_vertex_subset_cleanup(&frontier);
+		if (err) goto fail;
+		frontier = next;
+	}
+
+	agc_vertex_subset_cleanup(&frontier);
+	return AGC_OK;
+
+fail:
+	agc_u32vec_cleanup(OUT_parents);
+	return err;
+}
@@ -0,0 +1,21 @@
+#ifndef AGC_BFS_H
+#define AGC_BFS_H
+
+#include "error.h"
+#include "graph.h"
+#include "types.h"
+#include "vectors.h"
+
+#define AGC_BFS_NO_PARENT UINT32_MAX
+
+/* Direction-optimising breadth-first search on top of agc_edge_map.
+ * g_in is the transpose of g, or null when g is symmetric. On success
+ * OUT_parents is initialised with the BFS tree, the source being its own
+ * parent and unreached vertices AGC_BFS_NO_PARENT. */
+agc_err_t
+agc_bfs(const agc_csr_t  g[static 1],
+        const agc_csr_t *g_in,
+        u32              source,
+        agc_u32vec_t     OUT_parents[static 1]);
+
+#endif // !AGC_BFS_H
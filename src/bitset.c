@@ -0,0 +1,178 @@
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#endif
+#include <string.h>
+
+#include "bitset.h"
+
+static inline u32
+n_words(const agc_bitset_t bs[static 1])
+{
+	return agc_bitset_n_words(bs->n_bits);
+}
+
+static inline void
+mask_tail(agc_bitset_t bs[static 1])
+{
+	if (bs->n_bits & 63) bs->words.buf[n_words(bs) - 1] &= (1ull << (bs->n_bits & 63)) - 1;
+}
+
+agc_err_t
+agc_bitset_init(agc_bitset_t OUT_bs[static 1], u32 n_bits)
+{
+	if (!OUT_bs) return AGC_ERR_NULL;
+	agc_err_t err = AGC_OK;
+
+	int32_t words = (int32_t)agc_bitset_n_words(n_bits);
+
+	err = agc_u64vec_init(&OUT_bs->words, words);
+	if (err) return err;
+	err = agc_u64vec_resize(&OUT_bs->words, words);
+	if (err)
+	{
+		agc_u64vec_cleanup(&OUT_bs->words);
+		return err;
+	}
+
+	OUT_bs->n_bits = n_bits;
+	return AGC_OK;
+}
+
+void
+agc_bitset_cleanup(agc_bitset_t bs[static 1])
+{
+	if (!bs) return;
+
+	agc_u64vec_cleanup(&bs->words);
+	bs->n_bits = 0;
+}
+
+void
+agc_bitset_clear_all(agc_bitset_t bs[static 1])
+{
+	if (!bs) return;
+	memset(bs->words.buf, 0, sizeof(u64) * n_words(bs));
+}
+
+void
+agc_bitset_set_all(agc_bitset_t bs[static 1])
+{
+	if (!bs) return;
+	memset(bs->words.buf, 0xff, sizeof(u64) * n_words(bs));
+	mask_tail(bs);
+}
+
+/* The loops below are plain enough for the compiler to vectorise */
+#define BITSET_BINARY_OP(name, expr)                                                               \
+	agc_err_t agc_bitset_##name(agc_bitset_t dst[static 1], const agc_bitset_t src[static 1])  \
+	{                                                                                          \
+		if (!dst || !src) return AGC_ERR_NULL;                                             \
+		if (dst->n_bits != src->n_bits) return AGC_ERR_INVALID;                            \
+                                                                                                   \
+		u64       *d = dst->words.buf;                                                     \
+		const u64 *s = src->words.buf;                                                     \
+		u32        n = n_words(dst);                                                       \
+		for (u32 i = 0; i < n; i++)                                                        \
+			d[i] = (expr);                                                             \
+		return AGC_OK;                                                                     \
+	}
+
+BITSET_BINARY_OP(and, d[i] & s[i])
+BITSET_BINARY_OP(or, d[i] | s[i])
+BITSET_BINARY_OP(xor, d[i] ^ s[i])
+BITSET_BINARY_OP(andnot, d[i] & ~s[i])
+
+#if defined(__AVX2__)
+/* Nibble lookup popcount (Mula): each byte is split into two nibbles that
+ * index a 16-entry table with vpshufb, and the byte counts are summed
+ * per 64-bit lane with vpsadbw. */
+static u64
+popcount_words(const u64 *words, u32 n)
+{
+	const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+	                                        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i low_mask = _mm256_set1_epi8(0x0f);
+
+	__m256i acc = _mm256_setzero_si256();
+	u32     i   = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256i v   = _mm256_loadu_si256((const __m256i *)(words + i));
+		__m256i lo  = _mm256_and_si256(v, low_mask);
+		__m256i hi  = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+		__m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+		                              _mm256_shuffle_epi8(lookup, hi));
+		acc         = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+	}
+
+	u64 count = (u64)_mm256_extract_epi64(acc, 0) + (u64)_mm256_extract_epi64(acc, 1) +
+	            (u64)_mm256_extract_epi64(acc, 2) + (u64)_mm256_extract_epi64(acc, 3);
+	for (; i < n; i++)
+		count += (u64)__builtin_popcountll(words[i]);
+	return count;
+}
+#else
+static u64
+popcount_words(const u64 *words, u32 n)
+{
+	u64 count = 0;
+	for (u32 i = 0; i < n; i++)
+		count += (u64)__builtin_popcountll(words[i]);
+	return count;
+}
+#endif
+
+u64
+agc_bitset_count(const agc_bitset_t bs[static 1])
+{
+	if (!bs) return 0;
+	return popcount_words(bs->words.buf, n_words(bs));
+}
+
+agc_err_t
+agc_bitset_from_indices(agc_bitset_t       OUT_bs[static 1],
+                        u32                n_bits,
+                        const agc_u32vec_t idx[static 1])
+{
+	if (!OUT_bs || !idx) return AGC_ERR_NULL;
+	for (int32_t i = 0; i < idx->len; i++)
+		if (idx->buf[i] >= n_bits) return AGC_ERR_OOB;
+
+	agc_err_t err = agc_bitset_init(OUT_bs, n_bits);
+	if (err) return err;
+
+	for (int32_t i = 0; i < idx->len; i++)
+		agc_bitset_set(OUT_bs, idx->buf[i]);
+	return AGC_OK;
+}
+
+agc_err_t
+agc_bitset_to_indices(const agc_bitset_t bs[static 1], agc_u32vec_t OUT_idx[static 1])
+{
+	if (!bs || !OUT_idx) return AGC_ERR_NULL;
+	agc_err_t err = AGC_OK;
+
+	/* Presize from the popcount so the vector is allocated once */
+	u64 n_set = agc_bitset_count(bs);
+	if (n_set > INT32_MAX) return AGC_ERR_OVERFLOW;
+
+	int32_t count = (int32_t)n_set;
+
+	err = agc_u32vec_init(OUT_idx, count);
+	if (err) return err;
+
+	u32 *out = OUT_idx->buf;
+	u32  n   = n_words(bs);
+	for (u32 w = 0; w < n; w++)
+	{
+		u64 word = bs->words.buf[w];
+		while (word)
+		{
+			*out++ = w * 64 + (u32)__builtin_ctzll(word);
+			word &= word - 1;
+		}
+	}
+
+	OUT_idx->len = count;
+	return AGC_OK;
+}
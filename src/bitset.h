@@ -0,0 +1,123 @@
+#ifndef AGC_BITSET_H
+#define AGC_BITSET_H
+
+#include "error.h"
+#include "types.h"
+#include "vectors.h"
+
+/* Fixed-size bitset over u64 words, one bit per vertex.
+ * Bits past n_bits in the last word are kept clear, so whole-word
+ * operations and popcounts never see garbage. */
+typedef struct agc_bitset_t
+{
+	agc_u64vec_t words;
+	u32          n_bits;
+} agc_bitset_t;
+
+/* In u64, so n_bits close to UINT32_MAX does not wrap */
+#define agc_bitset_n_words(n_bits) ((u32)(((u64)(n_bits) + 63) / 64))
+
+/* Visits every set bit in ascending order */
+#define agc_bitset_foreach(bs, idx)                                                                \
+	for (u32(idx) = agc_bitset_next_set((bs), 0); (idx) < (bs)->n_bits;                        \
+	     (idx)    = agc_bitset_next_set((bs), (idx) + 1))
+
+agc_err_t
+agc_bitset_init(agc_bitset_t OUT_bs[static 1], u32 n_bits);
+
+void
+agc_bitset_cleanup(agc_bitset_t bs[static 1]);
+
+void
+agc_bitset_clear_all(agc_bitset_t bs[static 1]);
+
+void
+agc_bitset_set_all(agc_bitset_t bs[static 1]);
+
+/* Word-level bulk operations, dst = dst <op> src. Both bitsets must have
+ * the same size. */
+agc_err_t
+agc_bitset_and(agc_bitset_t dst[static 1], const agc_bitset_t src[static 1]);
+
+agc_err_t
+agc_bitset_or(agc_bitset_t dst[static 1], const agc_bitset_t src[static 1]);
+
+agc_err_t
+agc_bitset_xor(agc_bitset_t dst[static 1], const agc_bitset_t src[static 1]);
+
+agc_err_t
+agc_bitset_andnot(agc_bitset_t dst[static 1], const agc_bitset_t src[static 1]);
+
+/* Number of set bits */
+u64
+agc_bitset_count(const agc_bitset_t bs[static 1]);
+
+/* Builds a bitset of n_bits with the bits listed in idx set */
+agc_err_t
+agc_bitset_from_indices(agc_bitset_t       OUT_bs[static 1],
+                        u32                n_bits,
+                        const agc_u32vec_t idx[static 1]);
+
+/* Initialises OUT_idx with the positions of the set bits, ascending.
+ * AGC_ERR_OVERFLOW if more than INT32_MAX bits are set. */
+agc_err_t
+agc_bitset_to_indices(const agc_bitset_t bs[static 1], agc_u32vec_t OUT_idx[static 1]);
+
+/* Single-bit accessors are unchecked, they sit in the inner loops of the
+ * traversal kernels. */
+static inline bool
+agc_bitset_test(const agc_bitset_t bs[static 1], u32 i)
+{
+	return (bs->words.buf[i >> 6] >> (i & 63)) & 1;
+}
+
+static inline void
+agc_bitset_set(agc_bitset_t bs[static 1], u32 i)
+{
+	bs->words.buf[i >> 6] |= 1ull << (i & 63);
+}
+
+static inline void
+agc_bitset_reset(agc_bitset_t bs[static 1], u32 i)
+{
+	bs->words.buf[i >> 6] &= ~(1ull << (i & 63));
+}
+
+static inline void
+agc_bitset_set_atomic(agc_bitset_t bs[static 1], u32 i)
+{
+	__atomic_fetch_or(&bs->words.buf[i >> 6], 1ull << (i & 63), __ATOMIC_RELAXED);
+}
+
+/* Sets bit i and returns whether it was already set, so exactly one of
+ * several racing threads sees false. The plain load first avoids taking
+ * the cache line exclusive for bits that are already set. */
+static inline bool
+agc_bitset_test_and_set_atomic(agc_bitset_t bs[static 1], u32 i)
+{
+	u64 *word = &bs->words.buf[i >> 6];
+	u64  mask = 1ull << (i & 63);
+
+	if (__atomic_load_n(word, __ATOMIC_RELAXED) & mask) return true;
+	return __atomic_fetch_or(word, mask, __ATOMIC_RELAXED) & mask;
+}
+
+/* Position of the first set bit at or after from, n_bits if none */
+static inline u32
+agc_bitset_next_set(const agc_bitset_t bs[static 1], u32 from)
+{
+	if (from >= bs->n_bits) return bs->n_bits;
+
+	u32 w    = from >> 6;
+	u32 last = agc_bitset_n_words(bs->n_bits);
+	u64 word = bs->words.buf[w] & (~0ull << (from & 63));
+
+	while (!word)
+	{
+		if (++w == last) return bs->n_bits;
+		word = bs->words.buf[w];
+	}
+	return w * 64 + (u32)__builtin_ctzll(word);
+}
+
+#endif // !AGC_BITSET_H
@@ -11,6 +11,9 @@
 #define agc_paste2(a, b) agc_concat2(a, b)
 #define agc_paste3(a, b, c) agc_concat3(a, b, c)
 
+#define agc_stringify2(a) #a
+#define agc_stringify(a) agc_stringify2(a)
+
 #define agc_validate_interface(function, interface)                                                \
 	static_assert(_Generic((function), interface: 1, default: 0),                              \
 	              #function " does not match " #interface);
@@ -0,0 +1,274 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "components.h"
+
+#define AFFOREST_DEFAULT_ROUNDS 2
+#define AFFOREST_SAMPLES 1024
+#define NO_LABEL UINT32_MAX
+
+/* Turns a parent forest, where every entry already points at its root,
+ * into dense labels numbered by first appearance, and counts sizes. */
+static agc_err_t
+relabel_roots(const u32    parent[],
+              u32          n,
+              agc_u32vec_t OUT_labels[static 1],
+              agc_u32vec_t OUT_sizes[static 1])
+{
+	agc_err_t err = AGC_OK;
+
+	err = agc_u32vec_init(OUT_labels, (int32_t)n);
+	if (err) return err;
+	err = agc_u32vec_resize(OUT_labels, (int32_t)n);
+	if (err) goto fail_labels;
+	err = agc_u32vec_init(OUT_sizes, 0);
+	if (err) goto fail_labels;
+
+	/* Roots get their ids first, every other vertex copies its root's */
+	u32 *label = OUT_labels->buf;
+	for (u32 v = 0; v < n; v++)
+		label[v] = NO_LABEL;
+
+	for (u32 v = 0; v < n; v++)
+	{
+		u32 root = parent[v];
+		if (label[root] == NO_LABEL)
+		{
+			label[root] = (u32)OUT_sizes->len;
+			err         = agc_u32vec_push_cpy(OUT_sizes, 0);
+			if (err) goto fail_sizes;
+		}
+		OUT_sizes->buf[label[root]]++;
+	}
+
+	for (u32 v = 0; v < n; v++)
+		if (parent[v] != v) label[v] = label[parent[v]];
+
+	return AGC_OK;
+
+fail_sizes:
+	agc_u32vec_cleanup(OUT_sizes);
+fail_labels:
+	agc_u32vec_cleanup(OUT_labels);
+	return err;
+}
+
+/* ------------------------------ Union-find ------------------------------ */
+
+static u32
+uf_find(u32 parent[], u32 v)
+{
+	u32 root = v;
+	while (parent[root] != root)
+		root = parent[root];
+
+	while (parent[v] != root)
+	{
+		u32 next  = parent[v];
+		parent[v] = root;
+		v         = next;
+	}
+	return root;
+}
+
+agc_err_t
+agc_cc_union_find(const agc_csr_t g[static 1],
+                  agc_u32vec_t    OUT_labels[static 1],
+                  agc_u32vec_t    OUT_sizes[static 1])
+{
+	if (!g || !OUT_labels || !OUT_sizes) return AGC_ERR_NULL;
+	agc_err_t err = AGC_OK;
+
+	u32  n      = g->n_vertices;
+	u32 *parent = malloc(sizeof(u32) * agc_max(n, 1));
+	u32 *size   = malloc(sizeof(u32) * agc_max(n, 1));
+	if (!parent || !size)
+	{
+		err = AGC_ERR_MEMORY;
+		goto out;
+	}
+
+	for (u32 v = 0; v < n; v++)
+	{
+		parent[v] = v;
+		size[v]   = 1;
+	}
+
+	for (u32 u = 0; u < n; u++)
+	{
+		const u32 *nbrs = agc_csr_neighbours(g, u);
+		u32        deg  = agc_csr_degree(g, u);
+		for (u32 i = 0; i < deg; i++)
+		{
+			/* Every undirected edge is stored twice, only union it once */
+			if (nbrs[i] < u) continue;
+
+			u32 a = uf_find(parent, u);
+			u32 b = uf_find(parent, nbrs[i]);
+			if (a == b) continue;
+
+			if (size[a] < size[b])
+			{
+				u32 tmp = a;
+				a       = b;
+				b       = tmp;
+			}
+			parent[b] = a;
+			size[a] += size[b];
+		}
+	}
+
+	for (u32 v = 0; v < n; v++)
+		uf_find(parent, v);
+
+	err = relabel_roots(parent, n, OUT_labels, OUT_sizes);
+
+out:
+	free(parent);
+	free(size);
+	return err;
+}
+
+/* ------------------------------- Afforest ------------------------------- */
+
+static inline u32
+load_relaxed(const u32 *p)
+{
+	return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+/* Hooks the higher of the two roots under the lower one. Only roots are
+ * ever written, and only with a CAS, so concurrent links cannot lose a
+ * union or form a cycle. */
+static void
+afforest_link(u32 comp[], u32 u, u32 v)
+{
+	u32 p1 = load_relaxed(&comp[u]);
+	u32 p2 = load_relaxed(&comp[v]);
+
+	while (p1 != p2)
+	{
+		u32 high   = agc_max(p1, p2);
+		u32 low    = agc_min(p1, p2);
+		u32 p_high = load_relaxed(&comp[high]);
+
+		/* Already linked by someone else */
+		if (p_high == low) break;
+		if (p_high == high &&
+		    __atomic_compare_exchange_n(
+		            &comp[high], &p_high, low, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			break;
+
+		p1 = load_relaxed(&comp[load_relaxed(&comp[high])]);
+		p2 = load_relaxed(&comp[low]);
+	}
+}
+
+static void
+afforest_compress(u32 comp[], u32 n)
+{
+#pragma omp parallel for schedule(dynamic, 16384)
+	for (u32 v = 0; v < n; v++)
+	{
+		u32 p = load_relaxed(&comp[v]);
+		u32 q = load_relaxed(&comp[p]);
+		while (p != q)
+		{
+			__atomic_store_n(&comp[v], q, __ATOMIC_RELAXED);
+			p = q;
+			q = load_relaxed(&comp[p]);
+		}
+	}
+}
+
+static int
+u32_compare(const void *a, const void *b)
+{
+	u32 x = *(const u32 *)a;
+	u32 y = *(const u32 *)b;
+	return (x > y) - (x < y);
+}
+
+/* Estimates the largest intermediate component from a fixed-seed sample,
+ * so the result does not depend on the thread count. */
+static u32
+afforest_sample_frequent(const u32 comp[], u32 n)
+{
+	u32 samples[AFFOREST_SAMPLES];
+	u64 state = 0x9e3779b97f4a7c15ull;
+
+	for (u32 i = 0; i < AFFOREST_SAMPLES; i++)
+	{
+		/* splitmix64 */
+		u64 z = (state += 0x9e3779b97f4a7c15ull);
+		z     = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z     = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		z ^= z >> 31;
+		samples[i] = comp[z % n];
+	}
+	qsort(samples, AFFOREST_SAMPLES, sizeof(u32), u32_compare);
+
+	u32 best     = samples[0];
+	u32 best_run = 0;
+	u32 run      = 0;
+	for (u32 i = 0; i < AFFOREST_SAMPLES; i++)
+	{
+		run = (i > 0 && samples[i] == samples[i - 1]) ? run + 1 : 1;
+		if (run > best_run)
+		{
+			best_run = run;
+			best     = samples[i];
+		}
+	}
+	return best;
+}
+
+agc_err_t
+agc_cc_afforest(const agc_csr_t g[static 1],
+                u32             neighbour_rounds,
+                agc_u32vec_t    OUT_labels[static 1],
+                agc_u32vec_t    OUT_sizes[static 1])
+{
+	if (!g || !OUT_labels || !OUT_sizes) return AGC_ERR_NULL;
+	if (neighbour_rounds == 0) neighbour_rounds = AFFOREST_DEFAULT_ROUNDS;
+	agc_err_t err = AGC_OK;
+
+	u32  n    = g->n_vertices;
+	u32 *comp = malloc(sizeof(u32) * agc_max(n, 1));
+	if (!comp) return AGC_ERR_MEMORY;
+
+#pragma omp parallel for schedule(static)
+	for (u32 v = 0; v < n; v++)
+		comp[v] = v;
+
+	for (u32 r = 0; r < neighbour_rounds; r++)
+	{
+#pragma omp parallel for schedule(dynamic, 16384)
+		for (u32 u = 0; u < n; u++)
+		{
+			if (r < agc_csr_degree(g, u)) afforest_link(comp, u, agc_csr_neighbours(g, u)[r]);
+		}
+		afforest_compress(comp, n);
+	}
+
+	if (n > 0)
+	{
+		u32 frequent = afforest_sample_frequent(comp, n);
+
+#pragma omp parallel for schedule(dynamic, 16384)
+		for (u32 u = 0; u < n; u++)
+		{
+			if (load_relaxed(&comp[u]) == frequent) continue;
+
+			const u32 *nbrs = agc_csr_neighbours(g, u);
+			u32        deg  = agc_csr_degree(g, u);
+			for (u32 i = neighbour_rounds; i < deg; i++)
+				afforest_link(comp, u, nbrs[i]);
+		}
+		afforest_compress(comp, n);
+	}
+
+	err = relabel_roots(comp, n, OUT_labels, OUT_sizes);
+	free(comp);
+	return err;
+}
@@ -0,0 +1,33 @@
+#ifndef AGC_COMPONENTS_H
+#define AGC_COMPONENTS_H
+
+#include "error.h"
+#include "graph.h"
+#include "types.h"
+#include "vectors.h"
+
+/* Connected components of an undirected (symmetric) CSR graph.
+ *
+ * On success OUT_labels holds one dense component id per vertex and
+ * OUT_sizes the number of vertices of each component, so the number of
+ * components is OUT_sizes->len. Ids are assigned in order of the
+ * smallest vertex in each component. Both vectors are initialised by
+ * the call and must be cleaned up by the caller. */
+
+/* Sequential union-find with path compression and union by size */
+agc_err_t
+agc_cc_union_find(const agc_csr_t g[static 1],
+                  agc_u32vec_t    OUT_labels[static 1],
+                  agc_u32vec_t    OUT_sizes[static 1]);
+
+/* Parallel lock-free Afforest. The first neighbour_rounds neighbours of
+ * every vertex are linked up front; the remaining edges are then only
+ * visited for vertices outside the largest intermediate component.
+ * A neighbour_rounds of 0 selects the default of 2. */
+agc_err_t
+agc_cc_afforest(const agc_csr_t g[static 1],
+                u32             neighbour_rounds,
+                agc_u32vec_t    OUT_labels[static 1],
+                agc_u32vec_t    OUT_sizes[static 1]);
+
+#endif // !AGC_COMPONENTS_H
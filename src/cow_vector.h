@@ -0,0 +1,500 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "error.h"
+#include "types.h"
+
+#define AGC_COW_API [[maybe_unused]] static
+
+#ifndef AGC_COW_NAMESPACE
+	#error "You must define AGC_COW_NAMESPACE prior to the inclusion of cow_vector.h"
+#endif
+#ifndef T
+	#error "You must define T prior to the inclusion of cow_vector.h"
+#endif
+
+/* Copy-on-write vector with immutable, reference counted versions.
+ *
+ * Elements live in fixed-size chunks of 2^AGC_COW_CHUNK_SHIFT items, and
+ * a version is a length plus a table of chunk pointers. One writer edits
+ * the draft version. snapshot() only bumps a reference count; the next
+ * write then copies the chunk table and duplicates just the chunk it
+ * touches, so unmodified chunks stay shared between versions.
+ *
+ * publish() swaps the draft into the published pointer with an atomic
+ * exchange. Readers access it between read_begin() and read_end() on a
+ * reader slot of their own, which announces the epoch they entered in.
+ * A replaced version is retired with the epoch of its replacement and
+ * freed by reclaim() once no reader slot is still in an older epoch, so
+ * readers never take locks or touch reference counts.
+ *
+ * T is copied with memcpy and must not own resources. */
+
+/* Handle macro-generated names nicely */
+#define agc_cow_t agc_paste2(AGC_COW_NAMESPACE, _t)
+#define agc_cow_fn(name) agc_paste3(AGC_COW_NAMESPACE, _, name)
+#define agc_cow_chunk_t agc_paste2(AGC_COW_NAMESPACE, _chunk_t)
+#define agc_cow_version_t agc_paste2(AGC_COW_NAMESPACE, _version_t)
+#define agc_cow_chunks_t agc_paste2(AGC_COW_NAMESPACE, _chunks_t)
+#define agc_cow_chunks_fn(name) agc_paste3(AGC_COW_NAMESPACE, _chunks_, name)
+
+/* ----------------------- COW Interface Configuration ----------------------- */
+#ifndef AGC_COW_CHUNK_SHIFT
+	#define AGC_COW_CHUNK_SHIFT 10
+#endif
+#ifndef AGC_COW_MAX_READERS
+	#define AGC_COW_MAX_READERS 64
+#endif
+
+#define agc_cow_chunk_len (1 << AGC_COW_CHUNK_SHIFT)
+#define agc_cow_chunk_mask (agc_cow_chunk_len - 1)
+
+// clang-format off
+/* Interface Validation */
+#if (AGC_COW_CHUNK_SHIFT) < 0 || (AGC_COW_CHUNK_SHIFT) > 20
+#  error "AGC_COW_CHUNK_SHIFT must be in [0, 20]"
+#endif
+#if (AGC_COW_MAX_READERS) < 1
+#  error "AGC_COW_MAX_READERS must be >= 1"
+#endif
+/* ------------------------------------------------------------------------ */
+
+#ifndef AGC_COW_READER_SLOT_DEFINED
+#define AGC_COW_READER_SLOT_DEFINED
+/* Epoch a reader entered in, 0 when idle. One cache line each. */
+typedef struct agc_cow_reader_slot_t
+{
+	alignas(64) u64 epoch;
+} agc_cow_reader_slot_t;
+#endif
+
+typedef struct agc_cow_chunk_t
+{
+	u32 refs;
+	T   items[agc_cow_chunk_len];
+} agc_cow_chunk_t;
+
+/* The chunk table is a vector.h instance, which also takes its element
+ * type as T */
+#pragma push_macro("T")
+#undef T
+#define AGC_VEC_NAMESPACE agc_paste2(AGC_COW_NAMESPACE, _chunks)
+#define T agc_cow_chunk_t *
+#include "vector.h"
+#undef T
+#pragma pop_macro("T")
+
+typedef struct agc_cow_version_t
+{
+	u32                       refs;
+	int32_t                   len;
+	agc_cow_chunks_t          chunks;
+	u64                       retire_epoch;
+	struct agc_cow_version_t *next_retired;
+} agc_cow_version_t;
+
+typedef struct agc_cow_t
+{
+	agc_cow_version_t    *draft;
+	agc_cow_version_t    *published;
+	agc_cow_version_t    *retired;
+	u64                   epoch;
+	agc_cow_reader_slot_t readers[AGC_COW_MAX_READERS];
+} agc_cow_t;
+
+AGC_COW_API agc_err_t
+agc_cow_fn(init)(agc_cow_t OUT_cow[static 1], int32_t len);
+
+AGC_COW_API void
+agc_cow_fn(cleanup)(agc_cow_t cow[static 1]);
+
+AGC_COW_API int32_t
+agc_cow_fn(len)(const agc_cow_t cow[static 1]);
+
+AGC_COW_API T
+agc_cow_fn(get)(const agc_cow_t cow[static 1], int32_t pos);
+
+AGC_COW_API agc_err_t
+agc_cow_fn(ptr_mut)(agc_cow_t cow[static 1], int32_t pos, T *OUT_ptr[static 1]);
+
+AGC_COW_API agc_err_t
+agc_cow_fn(set)(agc_cow_t cow[static 1], int32_t pos, T value);
+
+AGC_COW_API agc_err_t
+agc_cow_fn(push)(agc_cow_t cow[static 1], T value);
+
+AGC_COW_API agc_err_t
+agc_cow_fn(resize)(agc_cow_t cow[static 1], int32_t new_len);
+
+AGC_COW_API agc_err_t
+agc_cow_fn(snapshot)(agc_cow_t cow[static 1], agc_cow_version_t *OUT_version[static 1]);
+
+AGC_COW_API agc_err_t
+agc_cow_fn(publish)(agc_cow_t cow[static 1]);
+
+AGC_COW_API void
+agc_cow_fn(reclaim)(agc_cow_t cow[static 1]);
+
+AGC_COW_API const agc_cow_version_t *
+agc_cow_fn(read_begin)(agc_cow_t cow[static 1], u32 slot);
+
+AGC_COW_API void
+agc_cow_fn(read_end)(agc_cow_t cow[static 1], u32 slot);
+
+AGC_COW_API void
+agc_cow_fn(version_acquire)(const agc_cow_version_t version[static 1]);
+
+AGC_COW_API void
+agc_cow_fn(version_release)(const agc_cow_version_t *version);
+
+AGC_COW_API int32_t
+agc_cow_fn(version_len)(const agc_cow_version_t version[static 1]);
+
+AGC_COW_API T
+agc_cow_fn(version_get)(const agc_cow_version_t version[static 1], int32_t pos);
+
+// clang-format on
+
+AGC_COW_API agc_cow_chunk_t *
+agc_cow_fn(chunk_new)(void)
+{
+	agc_cow_chunk_t *chunk = calloc(1, sizeof(agc_cow_chunk_t));
+	if (chunk) chunk->refs = 1;
+	return chunk;
+}
+
+AGC_COW_API void
+agc_cow_fn(chunk_release)(agc_cow_chunk_t *chunk)
+{
+	if (__atomic_sub_fetch(&chunk->refs, 1, __ATOMIC_ACQ_REL) == 0) free(chunk);
+}
+
+AGC_COW_API agc_cow_version_t *
+agc_cow_fn(version_new)(int32_t n_chunks)
+{
+	agc_cow_version_t *version = calloc(1, sizeof(agc_cow_version_t));
+	if (!version) return nullptr;
+
+	if (agc_cow_chunks_fn(init)(&version->chunks, agc_max(n_chunks, 1)))
+	{
+		free(version);
+		return nullptr;
+	}
+	version->refs = 1;
+	return version;
+}
+
+AGC_COW_API void
+agc_cow_fn(version_acquire)(const agc_cow_version_t version[static 1])
+{
+	agc_cow_version_t *v = (agc_cow_version_t *)version;
+	__atomic_add_fetch(&v->refs, 1, __ATOMIC_RELAXED);
+}
+
+AGC_COW_API void
+agc_cow_fn(version_release)(const agc_cow_version_t *version)
+{
+	if (!version) return;
+
+	agc_cow_version_t *v = (agc_cow_version_t *)version;
+	if (__atomic_sub_fetch(&v->refs, 1, __ATOMIC_ACQ_REL) != 0) return;
+
+	for (int32_t i = 0; i < v->chunks.len; i++)
+		agc_cow_fn(chunk_release)(v->chunks.buf[i]);
+	agc_cow_chunks_fn(cleanup)(&v->chunks);
+	free(v);
+}
+
+AGC_COW_API int32_t
+agc_cow_fn(version_len)(const agc_cow_version_t version[static 1])
+{
+	if (!version) return -1;
+	return version->len;
+}
+
+/* Unchecked */
+AGC_COW_API T
+agc_cow_fn(version_get)(const agc_cow_version_t version[static 1], int32_t pos)
+{
+	return version->chunks.buf[pos >> AGC_COW_CHUNK_SHIFT]->items[pos & agc_cow_chunk_mask];
+}
+
+/* Gives the writer a draft no snapshot refers to, sharing every chunk
+ * with the previous one */
+AGC_COW_API agc_err_t
+agc_cow_fn(draft_unshare)(agc_cow_t cow[static 1])
+{
+	agc_cow_version_t *old = cow->draft;
+	if (__atomic_load_n(&old->refs, __ATOMIC_ACQUIRE) == 1) return AGC_OK;
+
+	agc_cow_version_t *fresh = agc_cow_fn(version_new)(old->chunks.len);
+	if (!fresh) return AGC_ERR_MEMORY;
+
+	for (int32_t i = 0; i < old->chunks.len; i++)
+		__atomic_add_fetch(&old->chunks.buf[i]->refs, 1, __ATOMIC_RELAXED);
+
+	memcpy(fresh->chunks.buf, old->chunks.buf, sizeof(agc_cow_chunk_t *) * old->chunks.len);
+	fresh->chunks.len = old->chunks.len;
+	fresh->len        = old->len;
+	cow->draft        = fresh;
+	agc_cow_fn(version_release)(old);
+	return AGC_OK;
+}
+
+/* Makes chunk i of the draft private to it */
+AGC_COW_API agc_err_t
+agc_cow_fn(chunk_unshare)(agc_cow_t cow[static 1], int32_t i)
+{
+	agc_err_t err = agc_cow_fn(draft_unshare)(cow);
+	if (err) return err;
+
+	agc_cow_chunk_t *chunk = cow->draft->chunks.buf[i];
+	if (__atomic_load_n(&chunk->refs, __ATOMIC_ACQUIRE) == 1) return AGC_OK;
+
+	agc_cow_chunk_t *copy = malloc(sizeof(agc_cow_chunk_t));
+	if (!copy) return AGC_ERR_MEMORY;
+
+	memcpy(copy->items, chunk->items, sizeof(chunk->items));
+	copy->refs                = 1;
+	cow->draft->chunks.buf[i] = copy;
+	agc_cow_fn(chunk_release)(chunk);
+	return AGC_OK;
+}
+
+AGC_COW_API agc_err_t
+agc_cow_fn(init)(agc_cow_t OUT_cow[static 1], int32_t len)
+{
+	if (!OUT_cow) return AGC_ERR_NULL;
+	if (len < 0) return AGC_ERR_INVALID;
+
+	*OUT_cow = (agc_cow_t){ .epoch = 1 };
+
+	OUT_cow->draft = agc_cow_fn(version_new)(0);
+	if (!OUT_cow->draft) return AGC_ERR_MEMORY;
+
+	agc_err_t err = agc_cow_fn(resize)(OUT_cow, len);
+	if (err) agc_cow_fn(cleanup)(OUT_cow);
+	return err;
+}
+
+/* No reader may be inside a read section */
+AGC_COW_API void
+agc_cow_fn(cleanup)(agc_cow_t cow[static 1])
+{
+	if (!cow) return;
+
+	while (cow->retired)
+	{
+		agc_cow_version_t *next = cow->retired->next_retired;
+		agc_cow_fn(version_release)(cow->retired);
+		cow->retired = next;
+	}
+	agc_cow_fn(version_release)(cow->published);
+	agc_cow_fn(version_release)(cow->draft);
+	cow->published = nullptr;
+	cow->draft     = nullptr;
+}
+
+AGC_COW_API int32_t
+agc_cow_fn(len)(const agc_cow_t cow[static 1])
+{
+	if (!cow) return -1;
+	return cow->draft->len;
+}
+
+/* Unchecked read of the draft */
+AGC_COW_API T
+agc_cow_fn(get)(const agc_cow_t cow[static 1], int32_t pos)
+{
+	return agc_cow_fn(version_get)(cow->draft, pos);
+}
+
+/* Pointer to a writable element of the draft, valid until the next call
+ * that modifies or snapshots cow */
+AGC_COW_API agc_err_t
+agc_cow_fn(ptr_mut)(agc_cow_t cow[static 1], int32_t pos, T *OUT_ptr[static 1])
+{
+	if (!cow || !OUT_ptr) return AGC_ERR_NULL;
+	if (pos < 0 || pos >= cow->draft->len) return AGC_ERR_OOB;
+
+	int32_t   chunk = pos >> AGC_COW_CHUNK_SHIFT;
+	agc_err_t err   = agc_cow_fn(chunk_unshare)(cow, chunk);
+	if (err) return err;
+
+	*OUT_ptr = &cow->draft->chunks.buf[chunk]->items[pos & agc_cow_chunk_mask];
+	return AGC_OK;
+}
+
+AGC_COW_API agc_err_t
+agc_cow_fn(set)(agc_cow_t cow[static 1], int32_t pos, T value)
+{
+	T        *slot = nullptr;
+	agc_err_t err  = agc_cow_fn(ptr_mut)(cow, pos, &slot);
+	if (err) return err;
+
+	*slot = value;
+	return AGC_OK;
+}
+
+AGC_COW_API agc_err_t
+agc_cow_fn(push)(agc_cow_t cow[static 1], T value)
+{
+	if (!cow) return AGC_ERR_NULL;
+	if (cow->draft->len == INT32_MAX) return AGC_ERR_OVERFLOW;
+
+	agc_err_t err = agc_cow_fn(resize)(cow, cow->draft->len + 1);
+	if (err) return err;
+	return agc_cow_fn(set)(cow, cow->draft->len - 1, value);
+}
+
+/* New elements are zeroed */
+AGC_COW_API agc_err_t
+agc_cow_fn(resize)(agc_cow_t cow[static 1], int32_t new_len)
+{
+	if (!cow) return AGC_ERR_NULL;
+	if (new_len < 0) return AGC_ERR_INVALID;
+	if (new_len == cow->draft->len) return AGC_OK;
+
+	agc_err_t err = agc_cow_fn(draft_unshare)(cow);
+	if (err) return err;
+
+	agc_cow_version_t *draft    = cow->draft;
+	i64                rounded  = (i64)new_len + agc_cow_chunk_mask;
+	int32_t            n_chunks = (int32_t)(rounded >> AGC_COW_CHUNK_SHIFT);
+
+	while (draft->chunks.len > n_chunks)
+		agc_cow_fn(chunk_release)(draft->chunks.buf[--draft->chunks.len]);
+
+	/* The tail of the last chunk past len may hold stale values */
+	int32_t tail = draft->len & agc_cow_chunk_mask;
+	if (new_len > draft->len && tail)
+	{
+		err = agc_cow_fn(chunk_unshare)(cow, draft->len >> AGC_COW_CHUNK_SHIFT);
+		if (err) return err;
+
+		agc_cow_chunk_t *last = draft->chunks.buf[draft->len >> AGC_COW_CHUNK_SHIFT];
+		memset(last->items + tail, 0, sizeof(T) * (agc_cow_chunk_len - tail));
+	}
+
+	err = agc_cow_chunks_fn(grow)(&draft->chunks, n_chunks);
+	if (err) return err;
+
+	while (draft->chunks.len < n_chunks)
+	{
+		agc_cow_chunk_t *chunk = agc_cow_fn(chunk_new)();
+		if (!chunk)
+		{
+			draft->len = agc_min(draft->len, draft->chunks.len << AGC_COW_CHUNK_SHIFT);
+			return AGC_ERR_MEMORY;
+		}
+		draft->chunks.buf[draft->chunks.len++] = chunk;
+	}
+
+	draft->len = new_len;
+	return AGC_OK;
+}
+
+/* O(1) immutable copy of the draft, released with version_release */
+AGC_COW_API agc_err_t
+agc_cow_fn(snapshot)(agc_cow_t cow[static 1], agc_cow_version_t *OUT_version[static 1])
+{
+	if (!cow || !OUT_version) return AGC_ERR_NULL;
+
+	agc_cow_fn(version_acquire)(cow->draft);
+	*OUT_version = cow->draft;
+	return AGC_OK;
+}
+
+/* Makes the draft the version readers see and retires the previous one */
+AGC_COW_API agc_err_t
+agc_cow_fn(publish)(agc_cow_t cow[static 1])
+{
+	if (!cow) return AGC_ERR_NULL;
+
+	agc_cow_version_t *next = nullptr;
+	agc_cow_fn(snapshot)(cow, &next);
+
+	/* Readers announce their epoch before loading the pointer, so one that
+	 * still sees old has announced at most the epoch before the bump. */
+	agc_cow_version_t *old = __atomic_exchange_n(&cow->published, next, __ATOMIC_SEQ_CST);
+	u64                e   = __atomic_fetch_add(&cow->epoch, 1, __ATOMIC_SEQ_CST);
+	if (old)
+	{
+		old->retire_epoch = e;
+		old->next_retired = cow->retired;
+		cow->retired      = old;
+	}
+
+	agc_cow_fn(reclaim)(cow);
+	return AGC_OK;
+}
+
+/* Releases the retired versions no reader can still hold */
+AGC_COW_API void
+agc_cow_fn(reclaim)(agc_cow_t cow[static 1])
+{
+	if (!cow || !cow->retired) return;
+
+	u64 oldest = UINT64_MAX;
+	for (u32 i = 0; i < AGC_COW_MAX_READERS; i++)
+	{
+		u64 e = __atomic_load_n(&cow->readers[i].epoch, __ATOMIC_SEQ_CST);
+		if (e) oldest = agc_min(oldest, e);
+	}
+
+	agc_cow_version_t **link = &cow->retired;
+	while (*link)
+	{
+		agc_cow_version_t *v = *link;
+		if (v->retire_epoch < oldest)
+		{
+			*link = v->next_retired;
+			agc_cow_fn(version_release)(v);
+		}
+		else
+		{
+			link = &v->next_retired;
+		}
+	}
+}
+
+/* Enters a read section on slot, which must not be shared with another
+ * concurrent reader, and returns the published version or null. The
+ * version stays valid until read_end, or longer with version_acquire. */
+AGC_COW_API const agc_cow_version_t *
+agc_cow_fn(read_begin)(agc_cow_t cow[static 1], u32 slot)
+{
+	if (!cow || slot >= AGC_COW_MAX_READERS) return nullptr;
+
+	u64 e = __atomic_load_n(&cow->epoch, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&cow->readers[slot].epoch, e, __ATOMIC_SEQ_CST);
+	return __atomic_load_n(&cow->published, __ATOMIC_SEQ_CST);
+}
+
+AGC_COW_API void
+agc_cow_fn(read_end)(agc_cow_t cow[static 1], u32 slot)
+{
+	if (!cow || slot >= AGC_COW_MAX_READERS) return;
+	__atomic_store_n(&cow->readers[slot].epoch, 0, __ATOMIC_RELEASE);
+}
+
+/* ----------------------- COW Interface Cleanup ----------------------- */
+#ifdef AGC_COW_NAMESPACE
+	#undef AGC_COW_NAMESPACE
+#endif
+
+#ifdef AGC_COW_CHUNK_SHIFT
+	#undef AGC_COW_CHUNK_SHIFT
+#endif
+#ifdef AGC_COW_MAX_READERS
+	#undef AGC_COW_MAX_READERS
+#endif
+
+#ifdef agc_cow_chunk_len
+	#undef agc_cow_chunk_len
+#endif
+#ifdef agc_cow_chunk_mask
+	#undef agc_cow_chunk_mask
+#endif
@@ -0,0 +1,190 @@
+#include <stdlib.h>
+
+#include "edge_map.h"
+
+#define NO_VERTEX UINT32_MAX
+#define PACK_BLOCK 4096
+
+static inline bool
+accepts(const agc_edge_map_fns_t fns[static 1], u32 dst)
+{
+	return !fns->cond || fns->cond(dst, fns->ctx);
+}
+
+static u64
+frontier_out_degree(const agc_csr_t g[static 1], const agc_vertex_subset_t frontier[static 1])
+{
+	u64 degree = 0;
+
+	if (!frontier->dense)
+	{
+#pragma omp parallel for schedule(static) reduction(+ : degree)
+		for (int32_t i = 0; i < frontier->sparse.len; i++)
+			degree += agc_csr_degree(g, frontier->sparse.buf[i]);
+		return degree;
+	}
+
+	u32 n_words = agc_bitset_n_words(frontier->n);
+#pragma omp parallel for schedule(static) reduction(+ : degree)
+	for (u32 w = 0; w < n_words; w++)
+	{
+		u64 word = frontier->bits.words.buf[w];
+		while (word)
+		{
+			degree += agc_csr_degree(g, w * 64 + (u32)__builtin_ctzll(word));
+			word &= word - 1;
+		}
+	}
+	return degree;
+}
+
+/* Parallel stream compaction of the entries that are not NO_VERTEX */
+static agc_err_t
+pack_vertices(const u32 in[], u32 len, agc_u32vec_t OUT_ids[static 1])
+{
+	u32  n_blocks = (len + PACK_BLOCK - 1) / PACK_BLOCK;
+	u32 *starts   = calloc((size_t)n_blocks + 1, sizeof(u32));
+	if (!starts) return AGC_ERR_MEMORY;
+
+#pragma omp parallel for schedule(static)
+	for (u32 b = 0; b < n_blocks; b++)
+	{
+		u32 end   = agc_min((b + 1) * PACK_BLOCK, len);
+		u32 count = 0;
+		for (u32 i = b * PACK_BLOCK; i < end; i++)
+			count += in[i] != NO_VERTEX;
+		starts[b + 1] = count;
+	}
+	for (u32 b = 0; b < n_blocks; b++)
+		starts[b + 1] += starts[b];
+
+	agc_err_t err = agc_u32vec_init(OUT_ids, (int32_t)starts[n_blocks]);
+	if (err)
+	{
+		free(starts);
+		return err;
+	}
+
+#pragma omp parallel for schedule(static)
+	for (u32 b = 0; b < n_blocks; b++)
+	{
+		u32 end = agc_min((b + 1) * PACK_BLOCK, len);
+		u32 pos = starts[b];
+		for (u32 i = b * PACK_BLOCK; i < end; i++)
+			if (in[i] != NO_VERTEX) OUT_ids->buf[pos++] = in[i];
+	}
+
+	OUT_ids->len = (int32_t)starts[n_blocks];
+	free(starts);
+	return AGC_OK;
+}
+
+/* Every frontier vertex gets a slice of the output sized to its degree,
+ * so threads write without coordination and the result is packed once. */
+static agc_err_t
+edge_map_push(const agc_csr_t           g[static 1],
+              const agc_vertex_subset_t frontier[static 1],
+              const agc_edge_map_fns_t  fns[static 1],
+              agc_vertex_subset_t       OUT_next[static 1])
+{
+	const u32 *ids = frontier->sparse.buf;
+	u32        k   = (u32)frontier->sparse.len;
+
+	u32 *offsets = malloc(sizeof(u32) * ((size_t)k + 1));
+	if (!offsets) return AGC_ERR_MEMORY;
+
+	offsets[0] = 0;
+	for (u32 i = 0; i < k; i++)
+		offsets[i + 1] = offsets[i] + agc_csr_degree(g, ids[i]);
+
+	u32 *out = malloc(sizeof(u32) * agc_max(offsets[k], 1));
+	if (!out)
+	{
+		free(offsets);
+		return AGC_ERR_MEMORY;
+	}
+
+#pragma omp parallel for schedule(dynamic, 64)
+	for (u32 i = 0; i < k; i++)
+	{
+		u32        src  = ids[i];
+		const u32 *nbrs = agc_csr_neighbours(g, src);
+		u32        deg  = agc_csr_degree(g, src);
+		u32       *slot = out + offsets[i];
+
+		for (u32 j = 0; j < deg; j++)
+		{
+			u32 dst = nbrs[j];
+			slot[j] = (accepts(fns, dst) && fns->update_atomic(src, dst, fns->ctx)) ? dst
+			                                                                          : NO_VERTEX;
+		}
+	}
+
+	agc_u32vec_t next = { };
+	agc_err_t    err  = pack_vertices(out, offsets[k], &next);
+	if (!err) err = agc_vertex_subset_from_sparse(OUT_next, frontier->n, &next);
+
+	free(offsets);
+	free(out);
+	return err;
+}
+
+static agc_err_t
+edge_map_pull(const agc_csr_t           g_in[static 1],
+              const agc_vertex_subset_t frontier[static 1],
+              const agc_edge_map_fns_t  fns[static 1],
+              agc_vertex_subset_t       OUT_next[static 1])
+{
+	bool (*update)(u32, u32, void *) = fns->update ? fns->update : fns->update_atomic;
+
+	agc_bitset_t next = { };
+	agc_err_t    err  = agc_bitset_init(&next, frontier->n);
+	if (err) return err;
+
+	/* Chunks are multiples of 64 vertices, so every word of next is owned
+	 * by a single thread and can be written without atomics. */
+#pragma omp parallel for schedule(dynamic, 1024)
+	for (u32 dst = 0; dst < frontier->n; dst++)
+	{
+		if (!accepts(fns, dst)) continue;
+
+		const u32 *nbrs = agc_csr_neighbours(g_in, dst);
+		u32        deg  = agc_csr_degree(g_in, dst);
+		for (u32 j = 0; j < deg; j++)
+		{
+			u32 src = nbrs[j];
+			if (agc_bitset_test(&frontier->bits, src) && update(src, dst, fns->ctx))
+				agc_bitset_set(&next, dst);
+			if (!accepts(fns, dst)) break;
+		}
+	}
+
+	return agc_vertex_subset_from_dense(OUT_next, &next);
+}
+
+agc_err_t
+agc_edge_map(const agc_csr_t          g[static 1],
+             const agc_csr_t         *g_in,
+             agc_vertex_subset_t      frontier[static 1],
+             const agc_edge_map_fns_t fns[static 1],
+             agc_vertex_subset_t      OUT_next[static 1])
+{
+	if (!g || !frontier || !fns || !OUT_next || !fns->update_atomic) return AGC_ERR_NULL;
+	if (frontier->n != g->n_vertices) return AGC_ERR_INVALID;
+	if (g_in && g_in->n_vertices != g->n_vertices) return AGC_ERR_INVALID;
+	agc_err_t err = AGC_OK;
+
+	if (frontier->size == 0) return agc_vertex_subset_init_empty(OUT_next, frontier->n);
+
+	u64 work = frontier->size + frontier_out_degree(g, frontier);
+	if (work > agc_csr_n_edges(g) / AGC_EDGE_MAP_DENSE_DIVISOR)
+	{
+		err = agc_vertex_subset_to_dense(frontier);
+		if (err) return err;
+		return edge_map_pull(g_in ? g_in : g, frontier, fns, OUT_next);
+	}
+
+	err = agc_vertex_subset_to_sparse(frontier);
+	if (err) return err;
+	return edge_map_push(g, frontier, fns, OUT_next);
+}
@@ -0,0 +1,42 @@
+#ifndef AGC_EDGE_MAP_H
+#define AGC_EDGE_MAP_H
+
+#include "error.h"
+#include "graph.h"
+#include "types.h"
+#include "vertex_subset.h"
+
+/* Ligra-style frontier traversal.
+ *
+ * edge_map applies update to every edge (src, dst) with src in the
+ * frontier and cond(dst) true, and returns the set of dst for which an
+ * update returned true. Small frontiers are pushed along out-edges from
+ * a sparse list; once the frontier and its out-degree exceed
+ * |E| / AGC_EDGE_MAP_DENSE_DIVISOR it switches to pulling along in-edges
+ * into a bitmap, and stops scanning a dst as soon as cond turns false. */
+
+#define AGC_EDGE_MAP_DENSE_DIVISOR 20
+
+typedef struct agc_edge_map_fns_t
+{
+	/* Push direction: may run concurrently for the same dst, so it must
+	 * update dst atomically and return true for at most one caller. */
+	bool (*update_atomic)(u32 src, u32 dst, void *ctx);
+	/* Pull direction: dst is owned by the calling thread. Optional, falls
+	 * back to update_atomic. */
+	bool (*update)(u32 src, u32 dst, void *ctx);
+	/* Whether dst still wants updates. Optional, defaults to true. */
+	bool (*cond)(u32 dst, void *ctx);
+	void *ctx;
+} agc_edge_map_fns_t;
+
+/* g_in is the transpose of g, or null when g is symmetric. frontier may be
+ * converted between representations. OUT_next is initialised by the call. */
+agc_err_t
+agc_edge_map(const agc_csr_t          g[static 1],
+             const agc_csr_t         *g_in,
+             agc_vertex_subset_t      frontier[static 1],
+             const agc_edge_map_fns_t fns[static 1],
+             agc_vertex_subset_t      OUT_next[static 1]);
+
+#endif // !AGC_EDGE_MAP_H
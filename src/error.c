@@ -1,3 +1,4 @@
+#include <inttypes.h>
 #include <stdio.h>
 
 #include "error.h"
@@ -22,3 +23,23 @@ agc_write_error(agc_err_t e, FILE *f)
 {
 	fprintf(f, "Error: %s\n", agc_error_str(e));
 }
+
+void
+agc_write_vec_stats(char const *name, const agc_vec_stats_t *stats, FILE *f)
+{
+	if (!stats) return;
+
+	fprintf(f,
+	        "Vector stats [%s]: grow=%" PRIu64 " reserve=%" PRIu64 " realloc=%" PRIu64
+	        " allocated=%" PRIu64 "B peak_cap=%" PRIu64 " moved=%" PRIu64 "B spills=%" PRIu64
+	        " shrink=%" PRIu64 "\n",
+	        name ? name : "?",
+	        stats->grow_calls,
+	        stats->reserve_calls,
+	        stats->realloc_calls,
+	        stats->bytes_allocated,
+	        stats->peak_cap,
+	        stats->bytes_moved,
+	        stats->heap_spills,
+	        stats->shrink_calls);
+}
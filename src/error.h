@@ -1,5 +1,6 @@
 #ifndef AGC_ERROR_H
 #define AGC_ERROR_H
+#include <stdint.h>
 #include <stdio.h>
 
 #define AGC_ERROR_ENUM(X)                                                                          \
@@ -10,6 +11,8 @@
 	X(AGC_ERR_NOT_FOUND, "Not found")                                                          \
 	X(AGC_ERR_EXISTS, "Already exists")                                                        \
 	X(AGC_ERR_INVALID, "Invalid argument")                                                     \
+	X(AGC_ERR_OVERFLOW, "Arithmetic overflow")                                                 \
+	X(AGC_ERR_IO, "I/O error")                                                                 \
 	X(AGC_ERR_CALLBACK, "Callback error")
 
 #define AGC_ERROR_ENUM_DECLARE(E, MSG) E,
@@ -24,4 +27,22 @@ agc_error_str(agc_err_t e);
 void
 agc_write_error(agc_err_t e, FILE *f);
 
+/* Allocation and data movement counters of a vector namespace, collected
+ * when AGC_VEC_STATS is defined (see vector.h). The *_calls fields count
+ * every call, realloc_calls only those that reallocated. */
+typedef struct agc_vec_stats_t
+{
+	uint64_t grow_calls;
+	uint64_t reserve_calls;
+	uint64_t realloc_calls;
+	uint64_t bytes_allocated;
+	uint64_t peak_cap;
+	uint64_t bytes_moved;
+	uint64_t heap_spills;
+	uint64_t shrink_calls;
+} agc_vec_stats_t;
+
+void
+agc_write_vec_stats(char const *name, const agc_vec_stats_t *stats, FILE *f);
+
 #endif // !AGC_ERROR_H
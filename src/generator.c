@@ -0,0 +1,281 @@
+#include <stdckdint.h>
+
+#include "generator.h"
+
+/* Stream tags keep the draws of different generators apart */
+enum
+{
+	STREAM_RMAT   = 1,
+	STREAM_ER     = 2,
+	STREAM_WEIGHT = 3,
+};
+
+/* Philox4x32-10 (Salmon et al., SC'11) */
+static inline void
+philox4x32(u32 ctr[static 4], u64 seed)
+{
+	u32 k0 = (u32)seed;
+	u32 k1 = (u32)(seed >> 32);
+
+	/* Unrolled, the rounds of several draws in flight can interleave */
+#pragma GCC unroll 10
+	for (int r = 0; r < 10; r++)
+	{
+		u64 p0 = (u64)0xD2511F53u * ctr[0];
+		u64 p1 = (u64)0xCD9E8D57u * ctr[2];
+
+		u32 c0 = (u32)(p1 >> 32) ^ ctr[1] ^ k0;
+		u32 c2 = (u32)(p0 >> 32) ^ ctr[3] ^ k1;
+		ctr[1] = (u32)p1;
+		ctr[3] = (u32)p0;
+		ctr[0] = c0;
+		ctr[2] = c2;
+
+		k0 += 0x9E3779B9u;
+		k1 += 0xBB67AE85u;
+	}
+}
+
+/* Four random words for block `block` of item `index` in `stream` */
+static inline void
+draw(u32 OUT_words[static 4], u64 seed, u32 stream, u64 index, u32 block)
+{
+	OUT_words[0] = (u32)index;
+	OUT_words[1] = (u32)(index >> 32);
+	OUT_words[2] = block;
+	OUT_words[3] = stream;
+	philox4x32(OUT_words, seed);
+}
+
+/* Lemire's multiply-shift, uniform in [0, bound) up to a 2^-32 bias */
+static inline u32
+bounded(u32 word, u32 bound)
+{
+	return (u32)(((u64)word * bound) >> 32);
+}
+
+static inline u32
+edge_weight(u64 seed, u64 e, u32 max_weight)
+{
+	if (!max_weight) return 0;
+
+	u32 words[4];
+	draw(words, seed, STREAM_WEIGHT, e, 0);
+	return 1 + bounded(words[0], max_weight);
+}
+
+static agc_err_t
+init_edges(agc_edgevec_t OUT_edges[static 1], u64 m)
+{
+	if (m > INT32_MAX) return AGC_ERR_OVERFLOW;
+
+	agc_err_t err = agc_edgevec_init(OUT_edges, (int32_t)agc_max(m, 1));
+	if (err) return err;
+
+	/* Every slot is written by the generator, no need to zero them */
+	OUT_edges->len = (int32_t)m;
+	return AGC_OK;
+}
+
+/* Bijection on [0, 2^scale): odd multiplications and a xor-shift are all
+ * invertible modulo a power of two. */
+static inline u32
+scramble(u32 v, u32 scale, u64 seed)
+{
+	u64 mask = (1ull << scale) - 1;
+	u64 x    = v;
+
+	x = (x * (0x9E3779B97F4A7C15ull | 1) + seed) & mask;
+	x ^= x >> ((scale + 1) / 2);
+	x = (x * ((seed >> 32) | 1)) & mask;
+	return (u32)x;
+}
+
+agc_err_t
+agc_gen_rmat(agc_edgevec_t     OUT_edges[static 1],
+             u32               scale,
+             u32               edge_factor,
+             agc_rmat_params_t params,
+             u64               seed,
+             u32               max_weight)
+{
+	if (!OUT_edges) return AGC_ERR_NULL;
+	if (scale == 0 || scale > 30) return AGC_ERR_INVALID;
+	if (params.a < 0 || params.b < 0 || params.c < 0 || params.a + params.b + params.c > 1)
+		return AGC_ERR_INVALID;
+
+	u64       m   = (u64)edge_factor << scale;
+	agc_err_t err = init_edges(OUT_edges, m);
+	if (err) return err;
+
+	/* Quadrant thresholds on a 32-bit draw */
+	f64 full = 4294967296.0;
+	u64 t_a  = (u64)(params.a * full);
+	u64 t_ab = (u64)((params.a + params.b) * full);
+	u64 t_c  = (u64)((params.a + params.b + params.c) * full);
+
+	agc_edge_t *edges = OUT_edges->buf;
+
+#pragma omp parallel for schedule(static)
+	for (u64 e = 0; e < m; e++)
+	{
+		u32 src = 0;
+		u32 dst = 0;
+		u32 words[4];
+
+		/* One draw covers four levels. The quadrant choice is branch-free,
+		 * a random choice per level would mispredict about half the time. */
+		for (u32 level = 0; level < scale; level += 4)
+		{
+			draw(words, seed, STREAM_RMAT, e, level / 4);
+
+			u32 n_levels = agc_min(scale - level, 4u);
+#pragma GCC unroll 4
+			for (u32 k = 0; k < n_levels; k++)
+			{
+				u64 r     = words[k];
+				u32 down  = r >= t_ab;
+				u32 right = (r >= t_a && r < t_ab) | (r >= t_c);
+				src |= down << (level + k);
+				dst |= right << (level + k);
+			}
+		}
+
+		edges[e] = (agc_edge_t){
+			.src    = scramble(src, scale, seed),
+			.dst    = scramble(dst, scale, seed),
+			.weight = edge_weight(seed, e, max_weight),
+		};
+	}
+
+	return AGC_OK;
+}
+
+agc_err_t
+agc_gen_erdos_renyi(agc_edgevec_t OUT_edges[static 1],
+                    u32           n,
+                    u32           m,
+                    u64           seed,
+                    u32           max_weight)
+{
+	if (!OUT_edges) return AGC_ERR_NULL;
+	if (n == 0 && m > 0) return AGC_ERR_INVALID;
+	if (n >= INT32_MAX) return AGC_ERR_OVERFLOW;
+
+	agc_err_t err = init_edges(OUT_edges, m);
+	if (err) return err;
+
+	agc_edge_t *edges = OUT_edges->buf;
+
+#pragma omp parallel for schedule(static)
+	for (u32 e = 0; e < m; e++)
+	{
+		u32 words[4];
+		draw(words, seed, STREAM_ER, e, 0);
+
+		edges[e] = (agc_edge_t){
+			.src    = bounded(words[0], n),
+			.dst    = bounded(words[1], n),
+			.weight = edge_weight(seed, e, max_weight),
+		};
+	}
+
+	return AGC_OK;
+}
+
+agc_err_t
+agc_gen_grid_2d(agc_edgevec_t OUT_edges[static 1],
+                u32           rows,
+                u32           cols,
+                u64           seed,
+                u32           max_weight)
+{
+	if (!OUT_edges) return AGC_ERR_NULL;
+	if (rows == 0 || cols == 0) return AGC_ERR_INVALID;
+
+	u64 n = { };
+	if (ckd_mul(&n, (u64)rows, (u64)cols) || n >= INT32_MAX) return AGC_ERR_OVERFLOW;
+
+	/* Horizontal edges first, then vertical ones */
+	u64       n_right = (u64)rows * (cols - 1);
+	u64       m       = n_right + (u64)(rows - 1) * cols;
+	agc_err_t err     = init_edges(OUT_edges, m);
+	if (err) return err;
+
+	agc_edge_t *edges = OUT_edges->buf;
+
+#pragma omp parallel for schedule(static)
+	for (u32 r = 0; r < rows; r++)
+	{
+		for (u32 c = 0; c < cols; c++)
+		{
+			u32 v = r * cols + c;
+			if (c + 1 < cols)
+			{
+				u64 e    = (u64)r * (cols - 1) + c;
+				edges[e] = (agc_edge_t){ v, v + 1, edge_weight(seed, e, max_weight) };
+			}
+			if (r + 1 < rows)
+			{
+				u64 e    = n_right + (u64)r * cols + c;
+				edges[e] = (agc_edge_t){ v, v + cols, edge_weight(seed, e, max_weight) };
+			}
+		}
+	}
+
+	return AGC_OK;
+}
+
+agc_err_t
+agc_gen_grid_3d(agc_edgevec_t OUT_edges[static 1],
+                u32           nx,
+                u32           ny,
+                u32           nz,
+                u64           seed,
+                u32           max_weight)
+{
+	if (!OUT_edges) return AGC_ERR_NULL;
+	if (nx == 0 || ny == 0 || nz == 0) return AGC_ERR_INVALID;
+
+	u64 n = { };
+	if (ckd_mul(&n, (u64)nx * ny, (u64)nz) || n >= INT32_MAX) return AGC_ERR_OVERFLOW;
+
+	/* Edges along x, then y, then z */
+	u64       n_x = (u64)(nx - 1) * ny * nz;
+	u64       n_y = (u64)nx * (ny - 1) * nz;
+	u64       m   = n_x + n_y + (u64)nx * ny * (nz - 1);
+	agc_err_t err = init_edges(OUT_edges, m);
+	if (err) return err;
+
+	agc_edge_t *edges = OUT_edges->buf;
+	u32         plane = nx * ny;
+
+#pragma omp parallel for schedule(static)
+	for (u32 z = 0; z < nz; z++)
+	{
+		for (u32 y = 0; y < ny; y++)
+		{
+			for (u32 x = 0; x < nx; x++)
+			{
+				u32 v = z * plane + y * nx + x;
+				if (x + 1 < nx)
+				{
+					u64 e    = ((u64)z * ny + y) * (nx - 1) + x;
+					edges[e] = (agc_edge_t){ v, v + 1, edge_weight(seed, e, max_weight) };
+				}
+				if (y + 1 < ny)
+				{
+					u64 e    = n_x + ((u64)z * (ny - 1) + y) * nx + x;
+					edges[e] = (agc_edge_t){ v, v + nx, edge_weight(seed, e, max_weight) };
+				}
+				if (z + 1 < nz)
+				{
+					u64 e    = n_x + n_y + (u64)z * plane + y * nx + x;
+					edges[e] = (agc_edge_t){ v, v + plane, edge_weight(seed, e, max_weight) };
+				}
+			}
+		}
+	}
+
+	return AGC_OK;
+}
@@ -0,0 +1,69 @@
+#ifndef AGC_GENERATOR_H
+#define AGC_GENERATOR_H
+
+#include "error.h"
+#include "graph.h"
+#include "types.h"
+
+/* Synthetic graph generators for benchmarking.
+ *
+ * Every random draw comes from Philox4x32-10 keyed by the seed and
+ * indexed by the edge number, so the output only depends on the seed,
+ * never on the thread count or schedule. Edges are written in parallel
+ * straight into OUT_edges, which is initialised by the call; pass it to
+ * agc_csr_from_edges to get a CSR.
+ *
+ * With max_weight 0 all weights are 0, otherwise they are uniform in
+ * [1, max_weight]. Erdős-Rényi and the grids refuse graphs with more
+ * vertices than agc_csr_from_edges accepts with AGC_ERR_OVERFLOW. */
+
+typedef struct agc_rmat_params_t
+{
+	f64 a;
+	f64 b;
+	f64 c; /* d is 1 - a - b - c */
+} agc_rmat_params_t;
+
+#define AGC_RMAT_GRAPH500 ((agc_rmat_params_t){ .a = 0.57, .b = 0.19, .c = 0.19 })
+
+/* R-MAT / Kronecker graph with 2^scale vertices and edge_factor * 2^scale
+ * directed edges, scale in [1, 30]. Vertex ids are scrambled with a seeded
+ * bijection, as in Graph500, so high-degree vertices are not clustered at
+ * low ids. */
+agc_err_t
+agc_gen_rmat(agc_edgevec_t     OUT_edges[static 1],
+             u32               scale,
+             u32               edge_factor,
+             agc_rmat_params_t params,
+             u64               seed,
+             u32               max_weight);
+
+/* Erdős-Rényi G(n, m): m directed edges with uniform endpoints, drawn
+ * with replacement */
+agc_err_t
+agc_gen_erdos_renyi(agc_edgevec_t OUT_edges[static 1],
+                    u32           n,
+                    u32           m,
+                    u64           seed,
+                    u32           max_weight);
+
+/* 4-neighbour grid, vertex (r, c) is r * cols + c. Every undirected edge
+ * is emitted once. */
+agc_err_t
+agc_gen_grid_2d(agc_edgevec_t OUT_edges[static 1],
+                u32           rows,
+                u32           cols,
+                u64           seed,
+                u32           max_weight);
+
+/* 6-neighbour grid, vertex (x, y, z) is (z * ny + y) * nx + x. Every
+ * undirected edge is emitted once. */
+agc_err_t
+agc_gen_grid_3d(agc_edgevec_t OUT_edges[static 1],
+                u32           nx,
+                u32           ny,
+                u32           nz,
+                u64           seed,
+                u32           max_weight);
+
+#endif // !AGC_GENERATOR_H
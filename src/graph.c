@@ -0,0 +1,192 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "graph.h"
+
+/* Arcs are packed as (dst << 32 | weight) while building, so sorting a
+ * vertex's arcs orders them by neighbour first and by weight second. */
+static int
+arc_compare(const void *a, const void *b)
+{
+	u64 x = *(const u64 *)a;
+	u64 y = *(const u64 *)b;
+	return (x > y) - (x < y);
+}
+
+agc_err_t
+agc_csr_from_edges(agc_csr_t           OUT_g[static 1],
+                   u32                 n_vertices,
+                   const agc_edgevec_t edges[static 1],
+                   agc_csr_flags_t     flags)
+{
+	if (!OUT_g || !edges) return AGC_ERR_NULL;
+	if (n_vertices >= INT32_MAX) return AGC_ERR_OVERFLOW;
+	agc_err_t err = AGC_OK;
+
+	*OUT_g = (agc_csr_t){ .n_vertices = n_vertices };
+
+	bool symmetrize = flags & AGC_CSR_SYMMETRIZE;
+	bool weighted   = flags & AGC_CSR_WEIGHTED;
+	bool simple     = flags & AGC_CSR_SIMPLE;
+
+	int32_t n_arcs = { };
+	if (ckd_mul(&n_arcs, edges->len, symmetrize ? 2 : 1)) return AGC_ERR_OVERFLOW;
+
+	for (int32_t i = 0; i < edges->len; i++)
+	{
+		if (edges->buf[i].src >= n_vertices || edges->buf[i].dst >= n_vertices)
+			return AGC_ERR_OOB;
+	}
+
+	u32 *offsets = calloc((size_t)n_vertices + 1, sizeof(u32));
+	u32 *cursor  = malloc(sizeof(u32) * agc_max(n_vertices, 1));
+	u64 *arcs    = malloc(sizeof(u64) * agc_max(n_arcs, 1));
+	if (!offsets || !cursor || !arcs)
+	{
+		err = AGC_ERR_MEMORY;
+		goto out;
+	}
+
+	for (int32_t i = 0; i < edges->len; i++)
+	{
+		offsets[edges->buf[i].src + 1]++;
+		if (symmetrize) offsets[edges->buf[i].dst + 1]++;
+	}
+	for (u32 v = 0; v < n_vertices; v++)
+		offsets[v + 1] += offsets[v];
+
+	memcpy(cursor, offsets, sizeof(u32) * n_vertices);
+	for (int32_t i = 0; i < edges->len; i++)
+	{
+		agc_edge_t e = edges->buf[i];
+		u64        w = weighted ? e.weight : 0;
+
+		arcs[cursor[e.src]++] = (u64)e.dst << 32 | w;
+		if (symmetrize) arcs[cursor[e.dst]++] = (u64)e.src << 32 | w;
+	}
+
+#pragma omp parallel for schedule(dynamic, 1024)
+	for (u32 v = 0; v < n_vertices; v++)
+	{
+		qsort(arcs + offsets[v], offsets[v + 1] - offsets[v], sizeof(u64), arc_compare);
+	}
+
+	/* Parallel edges sort by ascending weight, so keeping the first one
+	 * keeps the lightest. */
+	if (simple)
+	{
+		u32 kept  = 0;
+		u32 begin = 0;
+		for (u32 v = 0; v < n_vertices; v++)
+		{
+			u32 end = offsets[v + 1];
+			for (u32 i = begin; i < end; i++)
+			{
+				u32 dst = (u32)(arcs[i] >> 32);
+				if (dst == v) continue;
+				if (kept > offsets[v] && (u32)(arcs[kept - 1] >> 32) == dst) continue;
+				arcs[kept++] = arcs[i];
+			}
+			offsets[v + 1] = kept;
+			begin          = end;
+		}
+		n_arcs = (int32_t)kept;
+	}
+
+	err = agc_u32vec_init(&OUT_g->offsets, (int32_t)n_vertices + 1);
+	if (err) goto out;
+	err = agc_u32vec_array_cpy(&OUT_g->offsets, 0, (int32_t)n_vertices + 1, offsets);
+	if (err) goto out;
+
+	err = agc_u32vec_init(&OUT_g->adj, n_arcs);
+	if (err) goto out;
+	err = agc_u32vec_resize(&OUT_g->adj, n_arcs);
+	if (err) goto out;
+
+	err = agc_u32vec_init(&OUT_g->weights, weighted ? n_arcs : 0);
+	if (err) goto out;
+	if (weighted)
+	{
+		err = agc_u32vec_resize(&OUT_g->weights, n_arcs);
+		if (err) goto out;
+	}
+
+#pragma omp parallel for schedule(static)
+	for (int32_t i = 0; i < n_arcs; i++)
+	{
+		OUT_g->adj.buf[i] = (u32)(arcs[i] >> 32);
+		if (weighted) OUT_g->weights.buf[i] = (u32)arcs[i];
+	}
+
+out:
+	if (err) agc_csr_cleanup(OUT_g);
+	free(offsets);
+	free(cursor);
+	free(arcs);
+	return err;
+}
+
+/* Counting sort on the destination. Sources are visited in ascending
+ * order, so every transposed adjacency list comes out sorted. */
+agc_err_t
+agc_csr_transpose(const agc_csr_t g[static 1], agc_csr_t OUT_t[static 1])
+{
+	if (!g || !OUT_t) return AGC_ERR_NULL;
+	agc_err_t err = AGC_OK;
+
+	u32     n        = g->n_vertices;
+	int32_t n_arcs   = g->adj.len;
+	bool    weighted = g->weights.len == n_arcs && n_arcs > 0;
+
+	*OUT_t = (agc_csr_t){ .n_vertices = n };
+
+	err = agc_u32vec_init(&OUT_t->offsets, (int32_t)n + 1);
+	if (!err) err = agc_u32vec_resize(&OUT_t->offsets, (int32_t)n + 1);
+	if (!err) err = agc_u32vec_init(&OUT_t->adj, n_arcs);
+	if (!err) err = agc_u32vec_resize(&OUT_t->adj, n_arcs);
+	if (!err) err = agc_u32vec_init(&OUT_t->weights, weighted ? n_arcs : 0);
+	if (!err && weighted) err = agc_u32vec_resize(&OUT_t->weights, n_arcs);
+	if (err) goto fail;
+
+	u32 *offsets = OUT_t->offsets.buf;
+	for (int32_t i = 0; i < n_arcs; i++)
+		offsets[g->adj.buf[i] + 1]++;
+	for (u32 v = 0; v < n; v++)
+		offsets[v + 1] += offsets[v];
+
+	u32 *cursor = malloc(sizeof(u32) * agc_max(n, 1));
+	if (!cursor)
+	{
+		err = AGC_ERR_MEMORY;
+		goto fail;
+	}
+	memcpy(cursor, offsets, sizeof(u32) * n);
+
+	for (u32 u = 0; u < n; u++)
+	{
+		for (u32 i = g->offsets.buf[u]; i < g->offsets.buf[u + 1]; i++)
+		{
+			u32 pos             = cursor[g->adj.buf[i]]++;
+			OUT_t->adj.buf[pos] = u;
+			if (weighted) OUT_t->weights.buf[pos] = g->weights.buf[i];
+		}
+	}
+
+	free(cursor);
+	return AGC_OK;
+
+fail:
+	agc_csr_cleanup(OUT_t);
+	return err;
+}
+
+void
+agc_csr_cleanup(agc_csr_t g[static 1])
+{
+	if (!g) return;
+
+	agc_u32vec_cleanup(&g->offsets);
+	agc_u32vec_cleanup(&g->adj);
+	agc_u32vec_cleanup(&g->weights);
+	g->n_vertices = 0;
+}
@@ -0,0 +1,71 @@
+#ifndef AGC_GRAPH_H
+#define AGC_GRAPH_H
+
+#include "error.h"
+#include "types.h"
+#include "vectors.h"
+
+typedef struct agc_edge_t
+{
+	u32 src;
+	u32 dst;
+	u32 weight;
+} agc_edge_t;
+
+#define AGC_VEC_NAMESPACE agc_edgevec
+#define T agc_edge_t
+#include "vector.h"
+#undef T
+
+typedef enum
+{
+	AGC_CSR_DEFAULT    = 0,
+	AGC_CSR_SYMMETRIZE = 1 << 0, /* Also insert the reverse of every edge */
+	AGC_CSR_WEIGHTED   = 1 << 1, /* Keep edge weights */
+	AGC_CSR_SIMPLE     = 1 << 2, /* Drop self loops and parallel edges */
+} agc_csr_flags_t;
+
+/* Compressed sparse row adjacency.
+ * The neighbours of v are adj[offsets[v] .. offsets[v + 1]), sorted in
+ * ascending order. weights is either empty or parallel to adj. */
+typedef struct agc_csr_t
+{
+	u32          n_vertices;
+	agc_u32vec_t offsets;
+	agc_u32vec_t adj;
+	agc_u32vec_t weights;
+} agc_csr_t;
+
+agc_err_t
+agc_csr_from_edges(agc_csr_t           OUT_g[static 1],
+                   u32                 n_vertices,
+                   const agc_edgevec_t edges[static 1],
+                   agc_csr_flags_t     flags);
+
+/* Initialises OUT_t with the reverse of every arc of g, keeping weights */
+agc_err_t
+agc_csr_transpose(const agc_csr_t g[static 1], agc_csr_t OUT_t[static 1]);
+
+void
+agc_csr_cleanup(agc_csr_t g[static 1]);
+
+/* Unchecked accessors for the hot loops of the graph kernels */
+static inline u32
+agc_csr_n_edges(const agc_csr_t g[static 1])
+{
+	return (u32)g->adj.len;
+}
+
+static inline u32
+agc_csr_degree(const agc_csr_t g[static 1], u32 v)
+{
+	return g->offsets.buf[v + 1] - g->offsets.buf[v];
+}
+
+static inline const u32 *
+agc_csr_neighbours(const agc_csr_t g[static 1], u32 v)
+{
+	return g->adj.buf + g->offsets.buf[v];
+}
+
+#endif // !AGC_GRAPH_H
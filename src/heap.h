@@ -0,0 +1,328 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "error.h"
+#include "types.h"
+#include "vectors.h"
+
+#define AGC_HEAP_API [[maybe_unused]] static
+
+#ifndef AGC_HEAP_NAMESPACE
+	#error "You must define AGC_HEAP_NAMESPACE prior to the inclusion of heap.h"
+#endif
+#ifndef K
+	#error "You must define K prior to the inclusion of heap.h"
+#endif
+
+/* Indexed d-ary min-heap.
+ * Items are ids in [0, capacity) ordered by a key of type K. A position
+ * index maps every id to its slot, which gives O(log_d n) decrease-key
+ * and membership tests without searching. Entries live in an agc_vec_t
+ * instantiated under <AGC_HEAP_NAMESPACE>_entries. */
+
+/* Handle macro-generated names nicely */
+#define agc_heap_t agc_paste2(AGC_HEAP_NAMESPACE, _t)
+#define agc_heap_fn(name) agc_paste3(AGC_HEAP_NAMESPACE, _, name)
+#define agc_heap_entry_t agc_paste2(AGC_HEAP_NAMESPACE, _entry_t)
+#define agc_heap_entries_t agc_paste2(AGC_HEAP_NAMESPACE, _entries_t)
+#define agc_heap_entries_fn(name) agc_paste3(AGC_HEAP_NAMESPACE, _entries_, name)
+
+#define AGC_HEAP_ABSENT UINT32_MAX
+
+/* ----------------------- Heap Interface Configuration ----------------------- */
+
+/* Key ordering, defaults to the < operator */
+#ifdef agc_heap_implements_key_compare
+	#define agc_heap_key_less(a, b) (agc_heap_fn(key_compare)(&(a), &(b)) < 0)
+#else
+	#define agc_heap_key_less(a, b) ((a) < (b))
+#endif
+
+#ifdef AGC_HEAP_ARITY
+#else
+	#define AGC_HEAP_ARITY 4
+#endif
+
+// clang-format off
+/* Interface Validation */
+#if (AGC_HEAP_ARITY) < 2
+#  error "AGC_HEAP_ARITY must be >= 2"
+#endif
+
+#ifdef agc_heap_implements_key_compare
+agc_validate_interface(agc_heap_fn(key_compare), int32_t (*)(const K *, const K *))
+#endif
+/* ------------------------------------------------------------------------ */
+
+typedef struct agc_heap_entry_t
+{
+	K   key;
+	u32 id;
+} agc_heap_entry_t;
+
+#define AGC_VEC_NAMESPACE agc_paste2(AGC_HEAP_NAMESPACE, _entries)
+#define T agc_heap_entry_t
+#include "vector.h"
+#undef T
+
+typedef struct agc_heap_t
+{
+	agc_heap_entries_t entries;
+	agc_u32vec_t       pos;
+} agc_heap_t;
+
+
+AGC_HEAP_API agc_err_t
+agc_heap_fn(init)(agc_heap_t OUT_heap[static 1], u32 capacity);
+
+AGC_HEAP_API void
+agc_heap_fn(cleanup)(agc_heap_t heap[static 1]);
+
+AGC_HEAP_API int32_t
+agc_heap_fn(len)(const agc_heap_t heap[static 1]);
+
+AGC_HEAP_API int32_t
+agc_heap_fn(empty)(const agc_heap_t heap[static 1]);
+
+AGC_HEAP_API bool
+agc_heap_fn(contains)(const agc_heap_t heap[static 1], u32 id);
+
+AGC_HEAP_API agc_err_t
+agc_heap_fn(push)(agc_heap_t heap[static 1], u32 id, K key);
+
+AGC_HEAP_API agc_err_t
+agc_heap_fn(decrease_key)(agc_heap_t heap[static 1], u32 id, K key);
+
+AGC_HEAP_API agc_err_t
+agc_heap_fn(push_or_decrease)(agc_heap_t heap[static 1], u32 id, K key);
+
+AGC_HEAP_API agc_err_t
+agc_heap_fn(top)(const agc_heap_t heap[static 1], u32 *OUT_id, K *OUT_key);
+
+AGC_HEAP_API agc_err_t
+agc_heap_fn(pop)(agc_heap_t heap[static 1], u32 *OUT_id, K *OUT_key);
+
+AGC_HEAP_API void
+agc_heap_fn(clear)(agc_heap_t heap[static 1]);
+
+// clang-format on
+
+AGC_HEAP_API agc_err_t
+agc_heap_fn(init)(agc_heap_t OUT_heap[static 1], u32 capacity)
+{
+	if (!OUT_heap) return AGC_ERR_NULL;
+	if (capacity >= INT32_MAX) return AGC_ERR_OVERFLOW;
+	agc_err_t err = AGC_OK;
+
+	err = agc_heap_entries_fn(init)(&OUT_heap->entries, 0);
+	if (err) return err;
+
+	err = agc_u32vec_init(&OUT_heap->pos, (int32_t)capacity);
+	if (err) goto fail_entries;
+	err = agc_u32vec_resize(&OUT_heap->pos, (int32_t)capacity);
+	if (err) goto fail_pos;
+
+	memset(OUT_heap->pos.buf, 0xff, sizeof(u32) * capacity);
+	return AGC_OK;
+
+fail_pos:
+	agc_u32vec_cleanup(&OUT_heap->pos);
+fail_entries:
+	agc_heap_entries_fn(cleanup)(&OUT_heap->entries);
+	return err;
+}
+
+AGC_HEAP_API void
+agc_heap_fn(cleanup)(agc_heap_t heap[static 1])
+{
+	if (!heap) return;
+
+	agc_heap_entries_fn(cleanup)(&heap->entries);
+	agc_u32vec_cleanup(&heap->pos);
+}
+
+AGC_HEAP_API int32_t
+agc_heap_fn(len)(const agc_heap_t heap[static 1])
+{
+	if (!heap) return -1;
+	return heap->entries.len;
+}
+
+AGC_HEAP_API int32_t
+agc_heap_fn(empty)(const agc_heap_t heap[static 1])
+{
+	if (!heap) return -1;
+	return (heap->entries.len == 0);
+}
+
+AGC_HEAP_API bool
+agc_heap_fn(contains)(const agc_heap_t heap[static 1], u32 id)
+{
+	if (!heap || id >= (u32)heap->pos.len) return false;
+	return heap->pos.buf[id] != AGC_HEAP_ABSENT;
+}
+
+/* Moves the entry at slot i towards the root, shifting larger parents
+ * down into the hole instead of swapping at every level. */
+AGC_HEAP_API void
+agc_heap_fn(sift_up)(agc_heap_t heap[static 1], u32 i)
+{
+	agc_heap_entry_t *buf   = heap->entries.buf;
+	agc_heap_entry_t  entry = buf[i];
+
+	while (i > 0)
+	{
+		u32 parent = (i - 1) / AGC_HEAP_ARITY;
+		if (!agc_heap_key_less(entry.key, buf[parent].key)) break;
+
+		buf[i]                   = buf[parent];
+		heap->pos.buf[buf[i].id] = i;
+		i                        = parent;
+	}
+
+	buf[i]                  = entry;
+	heap->pos.buf[entry.id] = i;
+}
+
+AGC_HEAP_API void
+agc_heap_fn(sift_down)(agc_heap_t heap[static 1], u32 i)
+{
+	agc_heap_entry_t *buf   = heap->entries.buf;
+	u32               len   = (u32)heap->entries.len;
+	agc_heap_entry_t  entry = buf[i];
+
+	for (;;)
+	{
+		u32 first = i * AGC_HEAP_ARITY + 1;
+		if (first >= len) break;
+
+		u32 last = agc_min(first + AGC_HEAP_ARITY, len);
+		u32 best = first;
+		for (u32 c = first + 1; c < last; c++)
+			if (agc_heap_key_less(buf[c].key, buf[best].key)) best = c;
+
+		if (!agc_heap_key_less(buf[best].key, entry.key)) break;
+
+		buf[i]                   = buf[best];
+		heap->pos.buf[buf[i].id] = i;
+		i                        = best;
+	}
+
+	buf[i]                  = entry;
+	heap->pos.buf[entry.id] = i;
+}
+
+AGC_HEAP_API agc_err_t
+agc_heap_fn(push)(agc_heap_t heap[static 1], u32 id, K key)
+{
+	if (!heap) return AGC_ERR_NULL;
+	if (id >= (u32)heap->pos.len) return AGC_ERR_OOB;
+	if (heap->pos.buf[id] != AGC_HEAP_ABSENT) return AGC_ERR_EXISTS;
+	agc_err_t err = AGC_OK;
+
+	agc_heap_entry_t entry = { .key = key, .id = id };
+
+	err = agc_heap_entries_fn(push_cpy)(&heap->entries, entry);
+	if (err) return err;
+
+	agc_heap_fn(sift_up)(heap, (u32)heap->entries.len - 1);
+	return err;
+}
+
+AGC_HEAP_API agc_err_t
+agc_heap_fn(decrease_key)(agc_heap_t heap[static 1], u32 id, K key)
+{
+	if (!heap) return AGC_ERR_NULL;
+	if (id >= (u32)heap->pos.len) return AGC_ERR_OOB;
+
+	u32 slot = heap->pos.buf[id];
+	if (slot == AGC_HEAP_ABSENT) return AGC_ERR_NOT_FOUND;
+	if (agc_heap_key_less(heap->entries.buf[slot].key, key)) return AGC_ERR_INVALID;
+
+	heap->entries.buf[slot].key = key;
+	agc_heap_fn(sift_up)(heap, slot);
+	return AGC_OK;
+}
+
+/* Inserts id, or lowers its key if it is queued with a larger one.
+ * A queued id with an equal or smaller key is left untouched. */
+AGC_HEAP_API agc_err_t
+agc_heap_fn(push_or_decrease)(agc_heap_t heap[static 1], u32 id, K key)
+{
+	if (!heap) return AGC_ERR_NULL;
+	if (id >= (u32)heap->pos.len) return AGC_ERR_OOB;
+
+	u32 slot = heap->pos.buf[id];
+	if (slot == AGC_HEAP_ABSENT) return agc_heap_fn(push)(heap, id, key);
+	if (!agc_heap_key_less(key, heap->entries.buf[slot].key)) return AGC_OK;
+
+	heap->entries.buf[slot].key = key;
+	agc_heap_fn(sift_up)(heap, slot);
+	return AGC_OK;
+}
+
+AGC_HEAP_API agc_err_t
+agc_heap_fn(top)(const agc_heap_t heap[static 1], u32 *OUT_id, K *OUT_key)
+{
+	if (!heap) return AGC_ERR_NULL;
+	if (heap->entries.len == 0) return AGC_ERR_NOT_FOUND;
+
+	if (OUT_id) *OUT_id = heap->entries.buf[0].id;
+	if (OUT_key) *OUT_key = heap->entries.buf[0].key;
+	return AGC_OK;
+}
+
+/* The last entry replaces the root, so unlike pop_at(0) on the backing
+ * vector nothing is shifted. */
+AGC_HEAP_API agc_err_t
+agc_heap_fn(pop)(agc_heap_t heap[static 1], u32 *OUT_id, K *OUT_key)
+{
+	if (!heap) return AGC_ERR_NULL;
+	if (heap->entries.len == 0) return AGC_ERR_NOT_FOUND;
+
+	agc_heap_entry_t root = heap->entries.buf[0];
+	agc_heap_entry_t last = { };
+
+	agc_heap_entries_fn(pop)(&heap->entries, &last);
+	heap->pos.buf[root.id] = AGC_HEAP_ABSENT;
+
+	if (heap->entries.len > 0)
+	{
+		heap->entries.buf[0] = last;
+		agc_heap_fn(sift_down)(heap, 0);
+	}
+
+	if (OUT_id) *OUT_id = root.id;
+	if (OUT_key) *OUT_key = root.key;
+	return AGC_OK;
+}
+
+AGC_HEAP_API void
+agc_heap_fn(clear)(agc_heap_t heap[static 1])
+{
+	if (!heap) return;
+
+	agc_heap_entries_fn(clear)(&heap->entries);
+	memset(heap->pos.buf, 0xff, sizeof(u32) * heap->pos.len);
+}
+
+/* ----------------------- Heap Interface Cleanup ----------------------- */
+#ifdef AGC_HEAP_NAMESPACE
+	#undef AGC_HEAP_NAMESPACE
+#endif
+#ifdef K
+	#undef K
+#endif
+
+#ifdef AGC_HEAP_ARITY
+	#undef AGC_HEAP_ARITY
+#endif
+
+#ifdef agc_heap_key_less
+	#undef agc_heap_key_less
+#endif
+#ifdef agc_heap_implements_key_compare
+	#undef agc_heap_implements_key_compare
+#endif
@@ -0,0 +1,332 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+
+/* Eight bytes per step folded with a 64x64 -> 128 bit multiply */
+static inline u64
+mum(u64 a, u64 b)
+{
+	unsigned __int128 r = (unsigned __int128)a * b;
+	return (u64)r ^ (u64)(r >> 64);
+}
+
+static u32
+hash_str(agc_strview_t str)
+{
+	const u64   k0 = 0xa0761d6478bd642full;
+	const u64   k1 = 0xe7037ed1a0b428dbull;
+	const char *p  = str.ptr;
+	u32         n  = str.len;
+	u64         h  = mum(k0 ^ n, k1);
+
+	for (; n >= 8; n -= 8, p += 8)
+	{
+		u64 w;
+		memcpy(&w, p, 8);
+		h = mum(h ^ w, k1);
+	}
+
+	u64 tail = 0;
+	if (n) memcpy(&tail, p, n);
+	h = mum(h ^ tail ^ k0, k1);
+	return (u32)(h ^ (h >> 32));
+}
+
+static inline bool
+slot_matches(const agc_intern_t table[static 1],
+             agc_intern_slot_t  slot,
+             agc_strview_t      str,
+             u32                hash)
+{
+	if (slot.hash != hash) return false;
+
+	agc_strview_t have = agc_intern_str(table, slot.ref - 1);
+	return have.len == str.len && memcmp(have.ptr, str.ptr, str.len) == 0;
+}
+
+/* Index of the slot holding str, or of the empty slot ending its probe */
+static u32
+probe(const agc_intern_t table[static 1], agc_strview_t str, u32 hash)
+{
+	const agc_intern_slot_t *slots = table->slots.buf;
+	u32                      mask  = (u32)table->slots.len - 1;
+
+	for (u32 pos = hash & mask;; pos = (pos + 1) & mask)
+	{
+		if (!slots[pos].ref || slot_matches(table, slots[pos], str, hash)) return pos;
+	}
+}
+
+/* Moves every slot into a fresh index of n_slots, a power of two */
+static agc_err_t
+rehash(agc_intern_t table[static 1], u32 n_slots)
+{
+	agc_intern_slots_t fresh = { };
+	agc_err_t          err   = agc_intern_slots_init(&fresh, (int32_t)n_slots);
+	if (err) return err;
+	err = agc_intern_slots_resize(&fresh, (int32_t)n_slots);
+	if (err)
+	{
+		agc_intern_slots_cleanup(&fresh);
+		return err;
+	}
+
+	u32 mask = n_slots - 1;
+	for (int32_t i = 0; i < table->slots.len; i++)
+	{
+		agc_intern_slot_t slot = table->slots.buf[i];
+		if (!slot.ref) continue;
+
+		u32 pos = slot.hash & mask;
+		while (fresh.buf[pos].ref)
+			pos = (pos + 1) & mask;
+		fresh.buf[pos] = slot;
+	}
+
+	agc_intern_slots_cleanup(&table->slots);
+	table->slots = fresh;
+	return AGC_OK;
+}
+
+/* Smallest power of two index keeping n_ids at most half full */
+static agc_err_t
+slots_for(u64 n_ids, u32 OUT_n_slots[static 1])
+{
+	u64 want = agc_max(n_ids * 2, 16);
+	if (want > (1ull << 30)) return AGC_ERR_OVERFLOW;
+
+	*OUT_n_slots = 1u << (64 - __builtin_clzll(want - 1));
+	return AGC_OK;
+}
+
+static agc_err_t
+reserve(agc_intern_t table[static 1], u64 n_ids, u64 n_bytes)
+{
+	if (n_ids >= INT32_MAX || n_bytes > INT32_MAX) return AGC_ERR_OVERFLOW;
+
+	u32       n_slots = 0;
+	agc_err_t err     = slots_for(n_ids, &n_slots);
+	if (err) return err;
+
+	if (n_slots > (u32)table->slots.len)
+	{
+		err = rehash(table, n_slots);
+		if (err) return err;
+	}
+	err = agc_u32vec_grow(&table->offsets, (int32_t)n_ids + 1);
+	if (err) return err;
+	return agc_bytevec_grow(&table->bytes, (int32_t)n_bytes);
+}
+
+static agc_err_t
+insert_hashed(agc_intern_t table[static 1], agc_strview_t str, u32 hash, u32 OUT_id[static 1])
+{
+	u32 pos = probe(table, str, hash);
+	if (table->slots.buf[pos].ref)
+	{
+		*OUT_id = table->slots.buf[pos].ref - 1;
+		return AGC_OK;
+	}
+
+	/* Grow before writing anything, so a failure leaves the table as is */
+	u32       id      = agc_intern_len(table);
+	u64       end     = (u64)table->bytes.len + str.len + 1;
+	int32_t   n_slots = table->slots.len;
+	agc_err_t err     = reserve(table, (u64)id + 1, end);
+	if (err) return err;
+	if (table->slots.len != n_slots) pos = probe(table, str, hash);
+
+	/* No slot refers to the new id yet, so the offset can go in first and
+	 * a failure leaves nothing to undo */
+	err = agc_u32vec_push_cpy(&table->offsets, (u32)end);
+	if (err) return err;
+
+	memcpy(table->bytes.buf + table->bytes.len, str.ptr, str.len);
+	table->bytes.buf[table->bytes.len + str.len] = '\0';
+	table->bytes.len                             = (int32_t)end;
+
+	table->slots.buf[pos] = (agc_intern_slot_t){ .hash = hash, .ref = id + 1 };
+	*OUT_id               = id;
+	return AGC_OK;
+}
+
+agc_err_t
+agc_intern_init(agc_intern_t OUT_table[static 1], u32 capacity)
+{
+	if (!OUT_table) return AGC_ERR_NULL;
+	agc_err_t err = AGC_OK;
+
+	*OUT_table = (agc_intern_t){ };
+
+	u32 n_slots = 0;
+	err         = slots_for(capacity, &n_slots);
+	if (err) return err;
+
+	err = agc_bytevec_init(&OUT_table->bytes, 64);
+	if (err) goto fail;
+	err = agc_u32vec_init(&OUT_table->offsets, (int32_t)agc_min(capacity, INT32_MAX - 1) + 1);
+	if (err) goto fail;
+	err = agc_u32vec_push_cpy(&OUT_table->offsets, 0);
+	if (err) goto fail;
+	err = rehash(OUT_table, n_slots);
+	if (err) goto fail;
+	return AGC_OK;
+
+fail:
+	agc_intern_cleanup(OUT_table);
+	return err;
+}
+
+void
+agc_intern_cleanup(agc_intern_t table[static 1])
+{
+	if (!table) return;
+	agc_bytevec_cleanup(&table->bytes);
+	agc_u32vec_cleanup(&table->offsets);
+	agc_intern_slots_cleanup(&table->slots);
+}
+
+agc_err_t
+agc_intern(agc_intern_t table[static 1], agc_strview_t str, u32 OUT_id[static 1])
+{
+	if (!table || !OUT_id || !str.ptr) return AGC_ERR_NULL;
+
+	return insert_hashed(table, str, hash_str(str), OUT_id);
+}
+
+agc_err_t
+agc_intern_find(const agc_intern_t table[static 1], agc_strview_t str, u32 OUT_id[static 1])
+{
+	if (!table || !OUT_id || !str.ptr) return AGC_ERR_NULL;
+
+	u32 pos = probe(table, str, hash_str(str));
+	if (!table->slots.buf[pos].ref) return AGC_ERR_NOT_FOUND;
+
+	*OUT_id = table->slots.buf[pos].ref - 1;
+	return AGC_OK;
+}
+
+/* Looks up strs[0 .. n) in groups of AGC_INTERN_PREFETCH_GROUP. A group is
+ * hashed first while prefetching every home slot, then the offsets and
+ * bytes of the candidates are prefetched, and only then are the probes
+ * run, so the cache misses of a whole group overlap. Unknown strings get
+ * AGC_INTERN_ABSENT. Returns how many there were. The hashes are kept in
+ * hashes[0 .. n) unless it is null. */
+static u32
+find_grouped(const agc_intern_t  table[static 1],
+             const agc_strview_t strs[],
+             u32                 n,
+             u32                 ids[],
+             u32                *hashes)
+{
+	const agc_intern_slot_t *slots     = table->slots.buf;
+	const u32               *offsets   = table->offsets.buf;
+	u32                      mask      = (u32)table->slots.len - 1;
+	u32                      group     = AGC_INTERN_PREFETCH_GROUP;
+	u32                      n_groups  = (n + group - 1) / group;
+	u32                      n_missing = 0;
+
+#pragma omp parallel for schedule(static) reduction(+ : n_missing)
+	for (u32 g = 0; g < n_groups; g++)
+	{
+		u32  first = g * group;
+		u32  count = agc_min(n - first, group);
+		u32  local[AGC_INTERN_PREFETCH_GROUP];
+		u32 *hash  = hashes ? hashes + first : local;
+
+		for (u32 k = 0; k < count; k++)
+		{
+			hash[k] = hash_str(strs[first + k]);
+			__builtin_prefetch(slots + (hash[k] & mask));
+		}
+		for (u32 k = 0; k < count; k++)
+		{
+			agc_intern_slot_t home = slots[hash[k] & mask];
+			if (home.ref) __builtin_prefetch(offsets + home.ref - 1);
+		}
+		for (u32 k = 0; k < count; k++)
+		{
+			agc_intern_slot_t home = slots[hash[k] & mask];
+			if (home.ref && home.hash == hash[k])
+				__builtin_prefetch(table->bytes.buf + offsets[home.ref - 1]);
+		}
+		for (u32 k = 0; k < count; k++)
+		{
+			u32 pos = probe(table, strs[first + k], hash[k]);
+			u32 ref = slots[pos].ref;
+
+			ids[first + k] = ref ? ref - 1 : AGC_INTERN_ABSENT;
+			n_missing += !ref;
+		}
+	}
+
+	return n_missing;
+}
+
+static agc_err_t
+ids_init(agc_u32vec_t OUT_ids[static 1], const agc_strview_t strs[], u32 n)
+{
+	if (!strs && n) return AGC_ERR_NULL;
+	if (n >= INT32_MAX) return AGC_ERR_OVERFLOW;
+
+	for (u32 i = 0; i < n; i++)
+	{
+		if (!strs[i].ptr) return AGC_ERR_NULL;
+	}
+
+	agc_err_t err = agc_u32vec_init(OUT_ids, (int32_t)agc_max(n, 1));
+	if (err) return err;
+	err = agc_u32vec_resize(OUT_ids, (int32_t)n);
+	if (err) agc_u32vec_cleanup(OUT_ids);
+	return err;
+}
+
+agc_err_t
+agc_intern_find_many(const agc_intern_t  table[static 1],
+                     const agc_strview_t strs[],
+                     u32                 n,
+                     agc_u32vec_t        OUT_ids[static 1])
+{
+	if (!table || !OUT_ids) return AGC_ERR_NULL;
+
+	agc_err_t err = ids_init(OUT_ids, strs, n);
+	if (err) return err;
+
+	find_grouped(table, strs, n, OUT_ids->buf, nullptr);
+	return AGC_OK;
+}
+
+agc_err_t
+agc_intern_bulk(agc_intern_t        table[static 1],
+                const agc_strview_t strs[],
+                u32                 n,
+                agc_u32vec_t        OUT_ids[static 1])
+{
+	if (!table || !OUT_ids) return AGC_ERR_NULL;
+
+	agc_err_t err = ids_init(OUT_ids, strs, n);
+	if (err) return err;
+
+	u32 *hashes = malloc(sizeof(u32) * agc_max(n, 1));
+	if (!hashes)
+	{
+		agc_u32vec_cleanup(OUT_ids);
+		return AGC_ERR_MEMORY;
+	}
+
+	/* The table is read-only here, so known strings resolve in parallel */
+	u32 *ids       = OUT_ids->buf;
+	u32  n_missing = find_grouped(table, strs, n, ids, hashes);
+
+	/* Misses may repeat, so they go through the regular insert which also
+	 * resolves the later copies to the id of the first. */
+	for (u32 i = 0; i < n && n_missing && !err; i++)
+	{
+		if (ids[i] == AGC_INTERN_ABSENT) err = insert_hashed(table, strs[i], hashes[i], &ids[i]);
+	}
+
+	free(hashes);
+	if (err) agc_u32vec_cleanup(OUT_ids);
+	return err;
+}
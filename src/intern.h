@@ -0,0 +1,103 @@
+#ifndef AGC_INTERN_H
+#define AGC_INTERN_H
+
+#include "error.h"
+#include "types.h"
+#include "vectors.h"
+
+/* String interning, mapping vertex names to dense ids 0, 1, 2, ...
+ *
+ * The strings live back to back in one byte arena, each followed by a
+ * NUL, and offsets[id] is where the string of id starts. Lookups go
+ * through an open-addressing index of (hash, id + 1) slots with linear
+ * probing, kept at most half full. The full hash is stored in the slot,
+ * so growing the index never touches the strings. */
+
+#define AGC_INTERN_ABSENT UINT32_MAX
+
+/* Lookups per group in agc_intern_find_many and agc_intern_bulk, which is
+ * how many cache misses they keep in flight */
+#ifndef AGC_INTERN_PREFETCH_GROUP
+	#define AGC_INTERN_PREFETCH_GROUP 16u
+#endif
+
+typedef struct agc_strview_t
+{
+	const char *ptr;
+	u32         len;
+} agc_strview_t;
+
+typedef struct agc_intern_slot_t
+{
+	u32 hash;
+	u32 ref; /* id + 1, 0 for an empty slot */
+} agc_intern_slot_t;
+
+#define AGC_VEC_NAMESPACE agc_bytevec
+#define T char
+#include "vector.h"
+#undef T
+
+#define AGC_VEC_NAMESPACE agc_intern_slots
+#define T agc_intern_slot_t
+#include "vector.h"
+#undef T
+
+typedef struct agc_intern_t
+{
+	agc_bytevec_t      bytes;
+	agc_u32vec_t       offsets; /* One entry per id plus the end of the arena */
+	agc_intern_slots_t slots;
+} agc_intern_t;
+
+/* capacity is a hint for the number of distinct strings */
+agc_err_t
+agc_intern_init(agc_intern_t OUT_table[static 1], u32 capacity);
+
+void
+agc_intern_cleanup(agc_intern_t table[static 1]);
+
+/* Returns the id of str, adding it if it is new */
+agc_err_t
+agc_intern(agc_intern_t table[static 1], agc_strview_t str, u32 OUT_id[static 1]);
+
+/* AGC_ERR_NOT_FOUND if str was never interned */
+agc_err_t
+agc_intern_find(const agc_intern_t table[static 1], agc_strview_t str, u32 OUT_id[static 1]);
+
+/* Batched agc_intern_find: OUT_ids[i] is the id of strs[i], or
+ * AGC_INTERN_ABSENT. Lookups are interleaved with prefetches and split
+ * across threads. OUT_ids is initialised by the call. */
+agc_err_t
+agc_intern_find_many(const agc_intern_t  table[static 1],
+                     const agc_strview_t strs[],
+                     u32                 n,
+                     agc_u32vec_t        OUT_ids[static 1]);
+
+/* Interns strs[0 .. n) for a loader. Hashing and the lookup of known
+ * strings run in parallel, new strings are then added in input order, so
+ * ids are the same as with n calls to agc_intern. OUT_ids is initialised
+ * by the call. */
+agc_err_t
+agc_intern_bulk(agc_intern_t        table[static 1],
+                const agc_strview_t strs[],
+                u32                 n,
+                agc_u32vec_t        OUT_ids[static 1]);
+
+static inline u32
+agc_intern_len(const agc_intern_t table[static 1])
+{
+	return (u32)table->offsets.len - 1;
+}
+
+/* Unchecked reverse lookup. The view is NUL terminated and stays valid
+ * until the next string is added. */
+static inline agc_strview_t
+agc_intern_str(const agc_intern_t table[static 1], u32 id)
+{
+	u32 begin = table->offsets.buf[id];
+	u32 end   = table->offsets.buf[id + 1];
+	return (agc_strview_t){ .ptr = table->bytes.buf + begin, .len = end - begin - 1 };
+}
+
+#endif // !AGC_INTERN_H
@@ -0,0 +1,116 @@
+#if defined(__AVX2__) || defined(__SSE2__)
+	#include <immintrin.h>
+#endif
+
+#include "intersect.h"
+
+static inline u32
+emit_matches(const u32 *block, u32 mask, u32 *OUT, u32 count)
+{
+	if (!OUT) return count + (u32)__builtin_popcount(mask);
+
+	while (mask)
+	{
+		OUT[count++] = block[__builtin_ctz(mask)];
+		mask &= mask - 1;
+	}
+	return count;
+}
+
+u32
+agc_intersect_u32(const u32 *a, u32 na, const u32 *b, u32 nb, u32 *OUT)
+{
+	u32 i     = 0;
+	u32 j     = 0;
+	u32 count = 0;
+
+#if defined(__AVX2__)
+	const __m256i rot1 = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+	while (i + 8 <= na && j + 8 <= nb)
+	{
+		__m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+		__m256i vb = _mm256_loadu_si256((const __m256i *)(b + j));
+		__m256i eq = _mm256_cmpeq_epi32(va, vb);
+		for (int r = 1; r < 8; r++)
+		{
+			vb = _mm256_permutevar8x32_epi32(vb, rot1);
+			eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+		}
+		u32 mask = (u32)_mm256_movemask_ps(_mm256_castsi256_ps(eq));
+		count    = emit_matches(a + i, mask, OUT, count);
+
+		u32 a_max = a[i + 7];
+		u32 b_max = b[j + 7];
+		i += (a_max <= b_max) * 8;
+		j += (b_max <= a_max) * 8;
+	}
+#endif
+
+#if defined(__SSE2__)
+	while (i + 4 <= na && j + 4 <= nb)
+	{
+		__m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + j));
+		__m128i eq = _mm_cmpeq_epi32(va, vb);
+		eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+		eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+		eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+		u32 mask = (u32)_mm_movemask_ps(_mm_castsi128_ps(eq));
+		count    = emit_matches(a + i, mask, OUT, count);
+
+		u32 a_max = a[i + 3];
+		u32 b_max = b[j + 3];
+		i += (a_max <= b_max) * 4;
+		j += (b_max <= a_max) * 4;
+	}
+#endif
+
+	while (i < na && j < nb)
+	{
+		if (a[i] < b[j])
+		{
+			i++;
+		}
+		else if (a[i] > b[j])
+		{
+			j++;
+		}
+		else
+		{
+			if (OUT) OUT[count] = a[i];
+			count++;
+			i++;
+			j++;
+		}
+	}
+
+	return count;
+}
+
+agc_err_t
+agc_intersect_count(const agc_u32vec_t a[static 1],
+                    const agc_u32vec_t b[static 1],
+                    u32               *OUT_count)
+{
+	if (!a || !b || !OUT_count) return AGC_ERR_NULL;
+
+	*OUT_count = agc_intersect_u32(a->buf, (u32)a->len, b->buf, (u32)b->len, nullptr);
+	return AGC_OK;
+}
+
+agc_err_t
+agc_intersect(const agc_u32vec_t a[static 1],
+              const agc_u32vec_t b[static 1],
+              agc_u32vec_t       dst[static 1])
+{
+	if (!a || !b || !dst) return AGC_ERR_NULL;
+	if (dst == a || dst == b) return AGC_ERR_INVALID;
+	agc_err_t err = AGC_OK;
+
+	agc_u32vec_clear(dst);
+	err = agc_u32vec_grow(dst, agc_max(agc_min(a->len, b->len), 1));
+	if (err) return err;
+
+	dst->len = (int32_t)agc_intersect_u32(a->buf, (u32)a->len, b->buf, (u32)b->len, dst->buf);
+	return err;
+}
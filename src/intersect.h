@@ -0,0 +1,32 @@
+#ifndef AGC_INTERSECT_H
+#define AGC_INTERSECT_H
+
+#include "error.h"
+#include "types.h"
+#include "vectors.h"
+
+/* Sorted-set intersection of two strictly ascending u32 arrays.
+ *
+ * Blocks of both inputs are compared all-against-all with shuffled
+ * SIMD compares (8x8 with AVX2, 4x4 with SSE2, scalar merge otherwise),
+ * and the block with the smaller maximum is advanced. The instruction
+ * set is picked at compile time.
+ *
+ * Returns the size of the intersection. If OUT is not null the common
+ * elements are written to it in ascending order; it must have room for
+ * agc_min(na, nb) elements. */
+u32
+agc_intersect_u32(const u32 *a, u32 na, const u32 *b, u32 nb, u32 *OUT);
+
+agc_err_t
+agc_intersect_count(const agc_u32vec_t a[static 1],
+                    const agc_u32vec_t b[static 1],
+                    u32               *OUT_count);
+
+/* Replaces the contents of dst, an initialised vector, with a ∩ b */
+agc_err_t
+agc_intersect(const agc_u32vec_t a[static 1],
+              const agc_u32vec_t b[static 1],
+              agc_u32vec_t       dst[static 1]);
+
+#endif // !AGC_INTERSECT_H
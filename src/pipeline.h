@@ -0,0 +1,134 @@
+#ifndef AGC_PIPELINE_H
+#define AGC_PIPELINE_H
+
+#include <stdint.h>
+
+#include "common.h"
+#include "error.h"
+#include "types.h"
+
+/* Lazy pipelines over any agc_vec_t, fused into a single loop.
+ *
+ * Every stage is a statement prefix, so a pipeline is a source followed
+ * by any number of stages and ends in the statement that consumes each
+ * element:
+ *
+ *     u64 sum = 0;
+ *     agc_pipe_from(&degrees, d)
+ *     agc_pipe_filter(*d > 1)
+ *     agc_pipe_map(sq, (u64)*d * *d)
+ *     agc_pipe_take(100)
+ *         agc_pipe_reduce(sum, +, sq);
+ *
+ * A source opens a for loop over the vector with a control block in
+ * scope, the other stages are single-pass for loops binding a name, or
+ * ifs. Nothing is materialised between stages. Like agc_vec_foreach
+ * this only relies on the buf and len members, so it works for every
+ * vector.h instance.
+ *
+ * A break in the body only leaves the innermost stage, so like continue
+ * it goes on with the next element. Use agc_pipe_stop() to end the whole
+ * pipeline. There is one take counter per pipeline. */
+
+typedef struct agc_pipe_ctl_t
+{
+	int32_t pos;   /* Current source position */
+	int32_t end;   /* Source length */
+	int32_t taken; /* Elements that went through agc_pipe_take */
+	int32_t limit; /* Argument of agc_pipe_take */
+	bool    stop;
+	bool    reserved; /* agc_pipe_collect sized its output */
+} agc_pipe_ctl_t;
+
+#define agc_pipe_pragma(x) _Pragma(#x)
+
+/* Binds decl for exactly one run of the following statement. Both loops
+ * clear the flag, so a break out of the inner one also ends the outer. */
+#define agc_pipe_let(decl)                                                                         \
+	for (bool agc_pipe_once_ = true; agc_pipe_once_; agc_pipe_once_ = false)                   \
+		for (decl; agc_pipe_once_; agc_pipe_once_ = false)
+
+#define agc_pipe_loop(n)                                                                           \
+	for (agc_pipe_ctl_t agc_pipe_ = { .end = (n), .limit = INT32_MAX };                        \
+	     !agc_pipe_.stop && agc_pipe_.pos < agc_pipe_.end;                                     \
+	     agc_pipe_.pos++)
+
+/* ------------------------------- Sources ------------------------------- */
+
+/* x points to each element of vec in turn */
+#define agc_pipe_from(vec, x)                                                                      \
+	agc_pipe_loop((vec)->len) agc_pipe_let(auto(x) = (vec)->buf + agc_pipe_.pos)
+
+/* Same as agc_pipe_from, with i the int32_t index of x */
+#define agc_pipe_enumerate(vec, i, x)                                                              \
+	agc_pipe_loop((vec)->len)                                                                  \
+	agc_pipe_let(int32_t(i) = agc_pipe_.pos) agc_pipe_let(auto(x) = (vec)->buf + (i))
+
+/* Pairs of elements of a and b, up to the shorter length */
+#define agc_pipe_zip(a, b, x, y)                                                                   \
+	agc_pipe_loop(agc_min((a)->len, (b)->len))                                                 \
+	agc_pipe_let(auto(x) = (a)->buf + agc_pipe_.pos)                                           \
+	agc_pipe_let(auto(y) = (b)->buf + agc_pipe_.pos)
+
+/* Consecutive runs of size elements: p points to the first one and n is
+ * size, or less for the last run */
+#define agc_pipe_chunk(vec, size, p, n)                                                            \
+	agc_pipe_loop((int32_t)(((int64_t)(vec)->len + (size) - 1) / (size)))                      \
+	agc_pipe_let(int64_t agc_pipe_first_ = (int64_t)agc_pipe_.pos * (size))                    \
+	agc_pipe_let(auto(p) = (vec)->buf + agc_pipe_first_)                                       \
+	agc_pipe_let(int32_t(n) = (int32_t)agc_min((vec)->len - agc_pipe_first_, (int64_t)(size)))
+
+/* Parallel sources. Stages run on OpenMP threads in no particular order,
+ * so only map, filter and side-effect free or atomic sinks may follow;
+ * take, collect and agc_pipe_stop need a sequential source. */
+#define agc_pipe_par_from(vec, x)                                                                  \
+	agc_pipe_pragma(omp parallel for schedule(static))                                         \
+	for (int32_t agc_pipe_i_ = 0; agc_pipe_i_ < (vec)->len; agc_pipe_i_++)                     \
+		agc_pipe_let(auto(x) = (vec)->buf + agc_pipe_i_)
+
+/* Parallel source combining the sink values into acc with the OpenMP
+ * reduction operator op */
+#define agc_pipe_par_reduce_from(op, acc, vec, x)                                                  \
+	agc_pipe_pragma(omp parallel for schedule(static) reduction(op : acc))                     \
+	for (int32_t agc_pipe_i_ = 0; agc_pipe_i_ < (vec)->len; agc_pipe_i_++)                     \
+		agc_pipe_let(auto(x) = (vec)->buf + agc_pipe_i_)
+
+/* -------------------------------- Stages -------------------------------- */
+
+#define agc_pipe_map(y, expr) agc_pipe_let(auto(y) = (expr))
+
+#define agc_pipe_filter(cond)                                                                      \
+	if (!(cond)) { }                                                                           \
+	else
+
+/* Lets the first n elements through and ends the pipeline on the last */
+#define agc_pipe_take(n)                                                                           \
+	if ((agc_pipe_.limit = (n)) <= agc_pipe_.taken) agc_pipe_stop();                           \
+	else if (++agc_pipe_.taken == agc_pipe_.limit && agc_pipe_stop() && false) { }             \
+	else
+
+/* --------------------------------- Sinks --------------------------------- */
+
+#define agc_pipe_stop() (agc_pipe_.stop = true)
+
+#define agc_pipe_reduce(acc, op, value) ((acc) = (acc)op(value))
+
+/* Appends value to out, an instance of the vector namespace ns. The first
+ * element reserves room for every element the source and take could
+ * still produce. On failure err is set and the pipeline stops. */
+#define agc_pipe_collect(ns, out, value, err)                                                      \
+	do                                                                                         \
+	{                                                                                          \
+		if (!agc_pipe_.reserved)                                                           \
+		{                                                                                  \
+			int64_t left_ = agc_min((int64_t)agc_pipe_.end - agc_pipe_.pos,            \
+			                        (int64_t)agc_pipe_.limit - agc_pipe_.taken + 1);   \
+			agc_pipe_.reserved = true;                                                 \
+			(err)              = agc_paste2(ns, _reserve)(                             \
+			        (out), (int32_t)agc_min((out)->len + left_, INT32_MAX));           \
+		}                                                                                  \
+		if (!(err)) (err) = agc_paste2(ns, _push_cpy)((out), (value));                     \
+		if (err) agc_pipe_.stop = true;                                                    \
+	} while (0)
+
+#endif // !AGC_PIPELINE_H
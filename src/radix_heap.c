@@ -0,0 +1,142 @@
+#include "radix_heap.h"
+
+static inline u32
+bucket_of(u32 key, u32 last)
+{
+	u32 diff = key ^ last;
+	return diff ? 32 - (u32)__builtin_clz(diff) : 0;
+}
+
+agc_err_t
+agc_radix_heap_init(agc_radix_heap_t OUT_heap[static 1])
+{
+	if (!OUT_heap) return AGC_ERR_NULL;
+	agc_err_t err = AGC_OK;
+
+	for (u32 b = 0; b < AGC_RADIX_HEAP_BUCKETS; b++)
+	{
+		err = agc_radix_entries_init(&OUT_heap->buckets[b], 0);
+		if (err)
+		{
+			while (b--)
+				agc_radix_entries_cleanup(&OUT_heap->buckets[b]);
+			return err;
+		}
+	}
+
+	OUT_heap->last = 0;
+	OUT_heap->len  = 0;
+	return AGC_OK;
+}
+
+void
+agc_radix_heap_cleanup(agc_radix_heap_t heap[static 1])
+{
+	if (!heap) return;
+
+	for (u32 b = 0; b < AGC_RADIX_HEAP_BUCKETS; b++)
+		agc_radix_entries_cleanup(&heap->buckets[b]);
+	heap->len = 0;
+}
+
+int32_t
+agc_radix_heap_len(const agc_radix_heap_t heap[static 1])
+{
+	if (!heap) return -1;
+	return heap->len;
+}
+
+int32_t
+agc_radix_heap_empty(const agc_radix_heap_t heap[static 1])
+{
+	if (!heap) return -1;
+	return (heap->len == 0);
+}
+
+agc_err_t
+agc_radix_heap_push(agc_radix_heap_t heap[static 1], u32 key, u32 value)
+{
+	if (!heap) return AGC_ERR_NULL;
+	if (key < heap->last) return AGC_ERR_INVALID;
+	agc_err_t err = AGC_OK;
+
+	agc_radix_entry_t entry = { .key = key, .value = value };
+
+	err = agc_radix_entries_push_cpy(&heap->buckets[bucket_of(key, heap->last)], entry);
+	if (err) return err;
+
+	heap->len++;
+	return err;
+}
+
+/* Refills bucket 0 from the lowest non-empty bucket. Its minimum becomes
+ * the new last key, and since all its entries share the bits above the
+ * bucket's, each one lands in a strictly lower bucket. Room is made in
+ * those buckets before last changes, so a failure leaves the heap as is. */
+static agc_err_t
+redistribute(agc_radix_heap_t heap[static 1])
+{
+	u32 b = 1;
+	while (heap->buckets[b].len == 0)
+		b++;
+
+	agc_radix_entries_t *src = &heap->buckets[b];
+
+	u32 min = UINT32_MAX;
+	for (int32_t i = 0; i < src->len; i++)
+		min = agc_min(min, src->buf[i].key);
+
+	int32_t counts[AGC_RADIX_HEAP_BUCKETS] = { };
+	for (int32_t i = 0; i < src->len; i++)
+		counts[bucket_of(src->buf[i].key, min)]++;
+
+	for (u32 t = 0; t < b; t++)
+	{
+		if (!counts[t]) continue;
+
+		agc_err_t err = agc_radix_entries_grow(&heap->buckets[t], heap->buckets[t].len + counts[t]);
+		if (err) return err;
+	}
+
+	heap->last = min;
+	for (int32_t i = 0; i < src->len; i++)
+	{
+		agc_radix_entry_t    entry = src->buf[i];
+		agc_radix_entries_t *dst   = &heap->buckets[bucket_of(entry.key, min)];
+		dst->buf[dst->len++]       = entry;
+	}
+	src->len = 0;
+	return AGC_OK;
+}
+
+agc_err_t
+agc_radix_heap_pop(agc_radix_heap_t heap[static 1], u32 *OUT_key, u32 *OUT_value)
+{
+	if (!heap) return AGC_ERR_NULL;
+	if (heap->len == 0) return AGC_ERR_NOT_FOUND;
+
+	if (heap->buckets[0].len == 0)
+	{
+		agc_err_t err = redistribute(heap);
+		if (err) return err;
+	}
+
+	agc_radix_entry_t entry = { };
+	agc_radix_entries_pop(&heap->buckets[0], &entry);
+	heap->len--;
+
+	if (OUT_key) *OUT_key = entry.key;
+	if (OUT_value) *OUT_value = entry.value;
+	return AGC_OK;
+}
+
+void
+agc_radix_heap_clear(agc_radix_heap_t heap[static 1])
+{
+	if (!heap) return;
+
+	for (u32 b = 0; b < AGC_RADIX_HEAP_BUCKETS; b++)
+		agc_radix_entries_clear(&heap->buckets[b]);
+	heap->last = 0;
+	heap->len  = 0;
+}
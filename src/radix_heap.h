@@ -0,0 +1,56 @@
+#ifndef AGC_RADIX_HEAP_H
+#define AGC_RADIX_HEAP_H
+
+#include "error.h"
+#include "types.h"
+
+/* Monotone radix heap over u32 keys.
+ *
+ * Keys pushed must not be smaller than the last key popped, which holds
+ * for Dijkstra-like searches. Entries sit in the bucket of the highest
+ * bit in which their key differs from the last popped key, so every
+ * entry is redistributed at most 32 times over its lifetime and push is
+ * O(1). The same value may be queued several times. */
+
+typedef struct agc_radix_entry_t
+{
+	u32 key;
+	u32 value;
+} agc_radix_entry_t;
+
+#define AGC_VEC_NAMESPACE agc_radix_entries
+#define T agc_radix_entry_t
+#include "vector.h"
+#undef T
+
+#define AGC_RADIX_HEAP_BUCKETS 33
+
+typedef struct agc_radix_heap_t
+{
+	agc_radix_entries_t buckets[AGC_RADIX_HEAP_BUCKETS];
+	u32                 last;
+	int32_t             len;
+} agc_radix_heap_t;
+
+agc_err_t
+agc_radix_heap_init(agc_radix_heap_t OUT_heap[static 1]);
+
+void
+agc_radix_heap_cleanup(agc_radix_heap_t heap[static 1]);
+
+int32_t
+agc_radix_heap_len(const agc_radix_heap_t heap[static 1]);
+
+int32_t
+agc_radix_heap_empty(const agc_radix_heap_t heap[static 1]);
+
+agc_err_t
+agc_radix_heap_push(agc_radix_heap_t heap[static 1], u32 key, u32 value);
+
+agc_err_t
+agc_radix_heap_pop(agc_radix_heap_t heap[static 1], u32 *OUT_key, u32 *OUT_value);
+
+void
+agc_radix_heap_clear(agc_radix_heap_t heap[static 1]);
+
+#endif // !AGC_RADIX_HEAP_H
@@ -0,0 +1,359 @@
+#include <stdckdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "radix_heap.h"
+#include "sssp.h"
+
+#define AGC_HEAP_NAMESPACE agc_dist_heap
+#define K u32
+#include "heap.h"
+
+/* Buckets smaller than this are drained by the thread that owns them
+ * without going through a global round */
+#define DELTA_LOCAL_BIN_THRESHOLD 1000
+#define NO_BIN UINT32_MAX
+
+static agc_err_t
+init_dist(const agc_csr_t g[static 1], u32 source, agc_u32vec_t OUT_dist[static 1])
+{
+	if (!g || !OUT_dist) return AGC_ERR_NULL;
+	if (source >= g->n_vertices) return AGC_ERR_OOB;
+	if (g->weights.len != g->adj.len) return AGC_ERR_INVALID;
+	agc_err_t err = AGC_OK;
+
+	err = agc_u32vec_init(OUT_dist, (int32_t)g->n_vertices);
+	if (err) return err;
+	err = agc_u32vec_resize(OUT_dist, (int32_t)g->n_vertices);
+	if (err)
+	{
+		agc_u32vec_cleanup(OUT_dist);
+		return err;
+	}
+
+	memset(OUT_dist->buf, 0xff, sizeof(u32) * g->n_vertices);
+	OUT_dist->buf[source] = 0;
+	return AGC_OK;
+}
+
+/* ------------------------------- Dijkstra ------------------------------- */
+
+agc_err_t
+agc_sssp_dijkstra(const agc_csr_t g[static 1], u32 source, agc_u32vec_t OUT_dist[static 1])
+{
+	agc_err_t err = init_dist(g, source, OUT_dist);
+	if (err) return err;
+
+	agc_dist_heap_t heap = { };
+	err                  = agc_dist_heap_init(&heap, g->n_vertices);
+	if (err) goto fail;
+
+	u32 *dist = OUT_dist->buf;
+	u32  u    = source;
+	u32  du   = 0;
+
+	err = agc_dist_heap_push(&heap, source, 0);
+	while (!err && agc_dist_heap_pop(&heap, &u, &du) == AGC_OK)
+	{
+		const u32 *nbrs    = agc_csr_neighbours(g, u);
+		const u32 *weights = g->weights.buf + g->offsets.buf[u];
+		u32        deg     = agc_csr_degree(g, u);
+
+		for (u32 i = 0; i < deg && !err; i++)
+		{
+			u32 nd = { };
+			if (ckd_add(&nd, du, weights[i]) || nd >= dist[nbrs[i]]) continue;
+
+			dist[nbrs[i]] = nd;
+			err           = agc_dist_heap_push_or_decrease(&heap, nbrs[i], nd);
+		}
+	}
+
+	agc_dist_heap_cleanup(&heap);
+	if (!err) return AGC_OK;
+fail:
+	agc_u32vec_cleanup(OUT_dist);
+	return err;
+}
+
+agc_err_t
+agc_sssp_dijkstra_radix(const agc_csr_t g[static 1], u32 source, agc_u32vec_t OUT_dist[static 1])
+{
+	agc_err_t err = init_dist(g, source, OUT_dist);
+	if (err) return err;
+
+	agc_radix_heap_t heap = { };
+	err                   = agc_radix_heap_init(&heap);
+	if (err) goto fail;
+
+	u32 *dist = OUT_dist->buf;
+	u32  u    = source;
+	u32  du   = 0;
+
+	err = agc_radix_heap_push(&heap, 0, source);
+	while (!err && agc_radix_heap_pop(&heap, &du, &u) == AGC_OK)
+	{
+		/* Superseded by a shorter path pushed later */
+		if (du > dist[u]) continue;
+
+		const u32 *nbrs    = agc_csr_neighbours(g, u);
+		const u32 *weights = g->weights.buf + g->offsets.buf[u];
+		u32        deg     = agc_csr_degree(g, u);
+
+		for (u32 i = 0; i < deg && !err; i++)
+		{
+			u32 nd = { };
+			if (ckd_add(&nd, du, weights[i]) || nd >= dist[nbrs[i]]) continue;
+
+			dist[nbrs[i]] = nd;
+			err           = agc_radix_heap_push(&heap, nd, nbrs[i]);
+		}
+	}
+
+	agc_radix_heap_cleanup(&heap);
+	if (!err) return AGC_OK;
+fail:
+	agc_u32vec_cleanup(OUT_dist);
+	return err;
+}
+
+/* ---------------------------- Delta-stepping ---------------------------- */
+
+/* Bins [base, base + DELTA_LOCAL_BIN_WINDOW) sit in a circular window,
+ * later ones share an overflow bin that is sorted out as the window moves
+ * forward, so a small delta with large weights stays in bounded memory */
+#define DELTA_LOCAL_BIN_WINDOW 128
+
+typedef struct local_bins_t
+{
+	agc_u32vec_t bins[DELTA_LOCAL_BIN_WINDOW];
+	u32          base;
+	agc_u32vec_t overflow;
+	u32          overflow_min; /* Lowest bin pushed to overflow */
+	agc_u32vec_t scratch;
+} local_bins_t;
+
+static inline agc_u32vec_t *
+local_bin(local_bins_t lb[static 1], u32 bin)
+{
+	return &lb->bins[bin % DELTA_LOCAL_BIN_WINDOW];
+}
+
+static agc_err_t
+local_bins_push(local_bins_t lb[static 1], u32 bin, u32 v)
+{
+	if (bin - lb->base < DELTA_LOCAL_BIN_WINDOW) return agc_u32vec_push_cpy(local_bin(lb, bin), v);
+
+	lb->overflow_min = agc_min(lb->overflow_min, bin);
+	return agc_u32vec_push_cpy(&lb->overflow, v);
+}
+
+/* Lowest non-empty bin from first on, or NO_BIN. Past the window this is
+ * only a lower bound, the overflow may hold stale entries for it. */
+static u32
+local_bins_lowest(local_bins_t lb[static 1], u32 first)
+{
+	for (u32 b = first; b - lb->base < DELTA_LOCAL_BIN_WINDOW; b++)
+	{
+		if (local_bin(lb, b)->len > 0) return b;
+	}
+	return lb->overflow.len > 0 ? lb->overflow_min : NO_BIN;
+}
+
+/* Moves the window to start at base, which must not skip a non-empty bin,
+ * and takes the overflow entries that now fall into it. Entries whose
+ * distance dropped below base were pushed again when it dropped. */
+static agc_err_t
+local_bins_advance(local_bins_t lb[static 1], u32 base, const u32 dist[], u32 delta)
+{
+	lb->base = base;
+	if (lb->overflow.len == 0 || lb->overflow_min - base >= DELTA_LOCAL_BIN_WINDOW) return AGC_OK;
+
+	agc_u32vec_t pending = lb->overflow;
+	lb->overflow         = lb->scratch;
+	lb->scratch          = pending;
+	lb->overflow_min     = NO_BIN;
+	agc_u32vec_clear(&lb->overflow);
+
+	for (int32_t i = 0; i < pending.len; i++)
+	{
+		u32 v   = pending.buf[i];
+		u32 bin = __atomic_load_n(&dist[v], __ATOMIC_RELAXED) / delta;
+		if (bin < base) continue;
+
+		agc_err_t err = local_bins_push(lb, bin, v);
+		if (err) return err;
+	}
+	return AGC_OK;
+}
+
+static void
+local_bins_cleanup(local_bins_t lb[static 1])
+{
+	for (u32 b = 0; b < DELTA_LOCAL_BIN_WINDOW; b++)
+		agc_u32vec_cleanup(&lb->bins[b]);
+	agc_u32vec_cleanup(&lb->overflow);
+	agc_u32vec_cleanup(&lb->scratch);
+}
+
+static void
+atomic_min_u32(u32 *p, u32 value)
+{
+	u32 old = __atomic_load_n(p, __ATOMIC_RELAXED);
+	while (value < old &&
+	       !__atomic_compare_exchange_n(p, &old, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+static agc_err_t
+relax_edges(const agc_csr_t g[static 1], u32 u, u32 delta, u32 dist[], local_bins_t lb[static 1])
+{
+	const u32 *nbrs    = agc_csr_neighbours(g, u);
+	const u32 *weights = g->weights.buf + g->offsets.buf[u];
+	u32        deg     = agc_csr_degree(g, u);
+	u32        du      = __atomic_load_n(&dist[u], __ATOMIC_RELAXED);
+
+	for (u32 i = 0; i < deg; i++)
+	{
+		u32 v  = nbrs[i];
+		u32 nd = { };
+		if (ckd_add(&nd, du, weights[i]) || nd == AGC_SSSP_INF) continue;
+
+		u32 old = __atomic_load_n(&dist[v], __ATOMIC_RELAXED);
+		while (nd < old)
+		{
+			if (__atomic_compare_exchange_n(
+			            &dist[v], &old, nd, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				agc_err_t err = local_bins_push(lb, nd / delta, v);
+				if (err) return err;
+				break;
+			}
+		}
+	}
+	return AGC_OK;
+}
+
+agc_err_t
+agc_sssp_delta_stepping(const agc_csr_t g[static 1],
+                        u32             source,
+                        u32             delta,
+                        agc_u32vec_t    OUT_dist[static 1])
+{
+	if (delta == 0) return AGC_ERR_INVALID;
+	agc_err_t err = init_dist(g, source, OUT_dist);
+	if (err) return err;
+
+	agc_u32vec_t frontier = { };
+	err                   = agc_u32vec_init(&frontier, (int32_t)agc_max(g->n_vertices, 1));
+	if (err) goto fail;
+	frontier.buf[0] = source;
+	frontier.len    = 1;
+
+	u32      *dist         = OUT_dist->buf;
+	u32       bin_index[2] = { 0, NO_BIN };
+	u32       tail[2]      = { 1, 0 };
+	agc_err_t shared_err   = AGC_OK;
+	bool      done         = false;
+
+	/* Rounds alternate between the two slots of bin_index and tail: one
+	 * describes the frontier being settled, the other collects the lowest
+	 * non-empty bin across threads for the next round. Whether to go on is
+	 * decided once per round into done, so all threads leave together
+	 * even when one of them fails while others are still in the round. */
+#pragma omp parallel
+	{
+		local_bins_t lb   = { .overflow_min = NO_BIN };
+		u32          iter = 0;
+
+		agc_err_t init_err = agc_u32vec_init(&lb.scratch, 0);
+		if (init_err) __atomic_store_n(&shared_err, init_err, __ATOMIC_RELAXED);
+#pragma omp barrier
+#pragma omp single
+		done = __atomic_load_n(&shared_err, __ATOMIC_RELAXED) != AGC_OK;
+
+		while (!done)
+		{
+			u32 *curr_bin  = &bin_index[iter & 1];
+			u32 *next_bin  = &bin_index[(iter + 1) & 1];
+			u32 *curr_tail = &tail[iter & 1];
+			u32 *next_tail = &tail[(iter + 1) & 1];
+			u32  n_front   = *curr_tail;
+			u64  lower     = (u64)*curr_bin * delta;
+
+			agc_err_t local_err = AGC_OK;
+
+#pragma omp for nowait schedule(dynamic, 64)
+			for (u32 i = 0; i < n_front; i++)
+			{
+				u32 u = frontier.buf[i];
+				/* Skip vertices already settled in an earlier bin */
+				if (__atomic_load_n(&dist[u], __ATOMIC_RELAXED) < lower || local_err) continue;
+				local_err = relax_edges(g, u, delta, dist, &lb);
+			}
+
+			agc_u32vec_t *own = local_bin(&lb, *curr_bin);
+			while (!local_err && own->len > 0 && own->len < DELTA_LOCAL_BIN_THRESHOLD)
+			{
+				agc_u32vec_t drained = *own;
+				*own                 = lb.scratch;
+				lb.scratch           = drained;
+				agc_u32vec_clear(own);
+
+				for (int32_t i = 0; i < drained.len && !local_err; i++)
+					local_err = relax_edges(g, drained.buf[i], delta, dist, &lb);
+			}
+
+			if (local_err) __atomic_store_n(&shared_err, local_err, __ATOMIC_RELAXED);
+
+			u32 lowest = local_bins_lowest(&lb, *curr_bin);
+			if (lowest != NO_BIN) atomic_min_u32(next_bin, lowest);
+
+#pragma omp barrier
+#pragma omp single nowait
+			{
+				*curr_bin  = NO_BIN;
+				*curr_tail = 0;
+			}
+
+			u32 bin   = *next_bin;
+			u32 count = 0;
+			u32 start = 0;
+			if (bin != NO_BIN && !local_err)
+			{
+				local_err = local_bins_advance(&lb, bin, dist, delta);
+				if (local_err) __atomic_store_n(&shared_err, local_err, __ATOMIC_RELAXED);
+				count = (u32)local_bin(&lb, bin)->len;
+				start = __atomic_fetch_add(next_tail, count, __ATOMIC_RELAXED);
+			}
+
+#pragma omp barrier
+#pragma omp single
+			{
+				agc_err_t grow_err = agc_u32vec_grow(&frontier, (int32_t)*next_tail);
+				if (grow_err) __atomic_store_n(&shared_err, grow_err, __ATOMIC_RELAXED);
+				else frontier.len = (int32_t)*next_tail;
+			}
+
+			if (count > 0 && !__atomic_load_n(&shared_err, __ATOMIC_RELAXED))
+			{
+				memcpy(frontier.buf + start, local_bin(&lb, bin)->buf, sizeof(u32) * count);
+				agc_u32vec_clear(local_bin(&lb, bin));
+			}
+
+			iter++;
+#pragma omp barrier
+#pragma omp single
+			done = __atomic_load_n(&shared_err, __ATOMIC_RELAXED) || bin_index[iter & 1] == NO_BIN;
+		}
+
+		local_bins_cleanup(&lb);
+	}
+
+	agc_u32vec_cleanup(&frontier);
+	err = shared_err;
+	if (!err) return AGC_OK;
+fail:
+	agc_u32vec_cleanup(OUT_dist);
+	return err;
+}
@@ -0,0 +1,37 @@
+#ifndef AGC_SSSP_H
+#define AGC_SSSP_H
+
+#include "error.h"
+#include "graph.h"
+#include "types.h"
+#include "vectors.h"
+
+/* Single-source shortest paths over a weighted CSR graph, i.e. one built
+ * with AGC_CSR_WEIGHTED. On success OUT_dist is initialised with one
+ * distance per vertex, AGC_SSSP_INF for unreachable ones. Paths whose
+ * length would not fit in a u32 are treated as unreachable. */
+
+#define AGC_SSSP_INF UINT32_MAX
+
+/* Sequential Dijkstra on an indexed 4-ary heap with decrease-key */
+agc_err_t
+agc_sssp_dijkstra(const agc_csr_t g[static 1], u32 source, agc_u32vec_t OUT_dist[static 1]);
+
+/* Sequential Dijkstra on a monotone radix heap, usually the faster of
+ * the two on integer weights */
+agc_err_t
+agc_sssp_dijkstra_radix(const agc_csr_t g[static 1], u32 source, agc_u32vec_t OUT_dist[static 1]);
+
+/* Parallel delta-stepping. Vertices are bucketed by distance / delta in
+ * thread-local bins and each bucket is settled by all threads before the
+ * next one is opened. Small buckets are drained thread-locally without a
+ * barrier. Only a window of buckets is kept per thread, the ones beyond it
+ * share an overflow bucket, so a small delta costs rounds but not memory.
+ * A delta of 0 is invalid. */
+agc_err_t
+agc_sssp_delta_stepping(const agc_csr_t g[static 1],
+                        u32             source,
+                        u32             delta,
+                        agc_u32vec_t    OUT_dist[static 1]);
+
+#endif // !AGC_SSSP_H
@@ -0,0 +1,483 @@
+/* pread and posix_fadvise */
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <threads.h>
+#include <unistd.h>
+
+#include "stream.h"
+
+/* Reads a list of edge files front to back into two alternating buffers.
+ * A slot is owned by the reader while full is false and by the consumer
+ * while it is true. A full slot of length 0 marks the end of the input. */
+typedef struct prefetch_t
+{
+	const int  *fds;
+	const u64  *n_edges;
+	u32         n_files;
+	u32         cap;
+	agc_edge_t *buf[2];
+	u32         len[2];
+	u32         file[2];
+	bool        full[2];
+	bool        stop;
+	agc_err_t   err;
+	mtx_t       lock;
+	cnd_t       cond;
+} prefetch_t;
+
+static agc_err_t
+pread_all(int fd, void *buf, size_t size, u64 offset)
+{
+	char *p = buf;
+	while (size)
+	{
+		ssize_t got = pread(fd, p, size, (off_t)offset);
+		if (got < 0 && errno == EINTR) continue;
+		if (got <= 0) return AGC_ERR_IO;
+		p += got;
+		size -= (size_t)got;
+		offset += (u64)got;
+	}
+	return AGC_OK;
+}
+
+static agc_err_t
+write_all(int fd, const void *buf, size_t size)
+{
+	const char *p = buf;
+	while (size)
+	{
+		ssize_t put = write(fd, p, size);
+		if (put < 0 && errno == EINTR) continue;
+		if (put <= 0) return AGC_ERR_IO;
+		p += put;
+		size -= (size_t)put;
+	}
+	return AGC_OK;
+}
+
+/* Waits until the reader may fill slot, false if the consumer gave up */
+static bool
+prefetch_acquire(prefetch_t p[static 1], u32 slot)
+{
+	mtx_lock(&p->lock);
+	while (p->full[slot] && !p->stop)
+		cnd_wait(&p->cond, &p->lock);
+	bool stop = p->stop;
+	mtx_unlock(&p->lock);
+	return !stop;
+}
+
+static void
+prefetch_publish(prefetch_t p[static 1], u32 slot, u32 len, u32 file, agc_err_t err)
+{
+	mtx_lock(&p->lock);
+	p->len[slot]  = len;
+	p->file[slot] = file;
+	p->full[slot] = true;
+	if (err) p->err = err;
+	cnd_broadcast(&p->cond);
+	mtx_unlock(&p->lock);
+}
+
+static int
+prefetch_main(void *arg)
+{
+	prefetch_t *p    = arg;
+	u32         slot = 0;
+
+	for (u32 f = 0; f < p->n_files; f++)
+	{
+		for (u64 done = 0; done < p->n_edges[f];)
+		{
+			if (!prefetch_acquire(p, slot)) return 0;
+
+			u32       len = (u32)agc_min(p->n_edges[f] - done, (u64)p->cap);
+			agc_err_t err = pread_all(p->fds[f],
+			                          p->buf[slot],
+			                          sizeof(agc_edge_t) * len,
+			                          sizeof(agc_edge_t) * done);
+			if (err)
+			{
+				prefetch_publish(p, slot, 0, f, err);
+				return 0;
+			}
+
+			prefetch_publish(p, slot, len, f, AGC_OK);
+			done += len;
+			slot ^= 1;
+		}
+	}
+
+	if (prefetch_acquire(p, slot)) prefetch_publish(p, slot, 0, p->n_files, AGC_OK);
+	return 0;
+}
+
+static agc_err_t
+prefetch_start(prefetch_t OUT_p[static 1],
+               thrd_t     OUT_thread[static 1],
+               const int *fds,
+               const u64 *n_edges,
+               u32        n_files,
+               u32        cap)
+{
+	*OUT_p = (prefetch_t){ .fds = fds, .n_edges = n_edges, .n_files = n_files, .cap = cap };
+
+	OUT_p->buf[0] = malloc(sizeof(agc_edge_t) * cap);
+	OUT_p->buf[1] = malloc(sizeof(agc_edge_t) * cap);
+	if (!OUT_p->buf[0] || !OUT_p->buf[1]) goto fail_buf;
+
+	if (mtx_init(&OUT_p->lock, mtx_plain) != thrd_success) goto fail_buf;
+	if (cnd_init(&OUT_p->cond) != thrd_success) goto fail_lock;
+	if (thrd_create(OUT_thread, prefetch_main, OUT_p) != thrd_success) goto fail_cond;
+	return AGC_OK;
+
+fail_cond:
+	cnd_destroy(&OUT_p->cond);
+fail_lock:
+	mtx_destroy(&OUT_p->lock);
+fail_buf:
+	free(OUT_p->buf[0]);
+	free(OUT_p->buf[1]);
+	return AGC_ERR_MEMORY;
+}
+
+/* Blocks until slot is filled and returns the reader error so far.
+ * OUT_len is the length of the slot, 0 at the end or after an error. */
+static agc_err_t
+prefetch_wait(prefetch_t p[static 1], u32 slot, u32 OUT_len[static 1])
+{
+	mtx_lock(&p->lock);
+	while (!p->full[slot])
+		cnd_wait(&p->cond, &p->lock);
+	*OUT_len      = p->len[slot];
+	agc_err_t err = p->err;
+	mtx_unlock(&p->lock);
+	return err;
+}
+
+static void
+prefetch_release(prefetch_t p[static 1], u32 slot)
+{
+	mtx_lock(&p->lock);
+	p->full[slot] = false;
+	cnd_broadcast(&p->cond);
+	mtx_unlock(&p->lock);
+}
+
+/* Stops the reader if it is still running and returns its error */
+static agc_err_t
+prefetch_finish(prefetch_t p[static 1], thrd_t thread)
+{
+	mtx_lock(&p->lock);
+	p->stop = true;
+	cnd_broadcast(&p->cond);
+	mtx_unlock(&p->lock);
+
+	thrd_join(thread, nullptr);
+	cnd_destroy(&p->cond);
+	mtx_destroy(&p->lock);
+	free(p->buf[0]);
+	free(p->buf[1]);
+	return p->err;
+}
+
+/* n descriptors, all -1 until opened */
+static int *
+fds_alloc(u32 n)
+{
+	u32  cap = agc_max(n, 1);
+	int *fds = malloc(sizeof(int) * cap);
+	for (u32 k = 0; fds && k < cap; k++)
+		fds[k] = -1;
+	return fds;
+}
+
+/* Closes the descriptors that were opened and frees fds */
+static agc_err_t
+fds_close(int *fds, u32 n)
+{
+	agc_err_t err = AGC_OK;
+	for (u32 k = 0; fds && k < n; k++)
+	{
+		if (fds[k] >= 0 && close(fds[k]) != 0) err = AGC_ERR_IO;
+	}
+	free(fds);
+	return err;
+}
+
+static char *
+shard_path(char const *prefix, u32 shard)
+{
+	size_t size = strlen(prefix) + 12;
+	char  *path = malloc(size);
+	if (path) snprintf(path, size, "%s.%u", prefix, shard);
+	return path;
+}
+
+/* Deletes the files of shards [0, n_shards) */
+static agc_err_t
+shards_unlink(char const *prefix, u32 n_shards)
+{
+	agc_err_t err = AGC_OK;
+	for (u32 k = 0; k < n_shards; k++)
+	{
+		char *path = shard_path(prefix, k);
+		if (!path) return AGC_ERR_MEMORY;
+		if (unlink(path) != 0 && errno != ENOENT) err = AGC_ERR_IO;
+		free(path);
+	}
+	return err;
+}
+
+static agc_err_t
+edge_file_open(char const *path, int OUT_fd[static 1], u64 OUT_n_edges[static 1])
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return AGC_ERR_IO;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return AGC_ERR_IO;
+	}
+	if ((u64)st.st_size % sizeof(agc_edge_t))
+	{
+		close(fd);
+		return AGC_ERR_INVALID;
+	}
+
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	*OUT_fd      = fd;
+	*OUT_n_edges = (u64)st.st_size / sizeof(agc_edge_t);
+	return AGC_OK;
+}
+
+agc_err_t
+agc_edge_file_write(char const *path, const agc_edgevec_t edges[static 1])
+{
+	if (!path || !edges) return AGC_ERR_NULL;
+
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) return AGC_ERR_IO;
+
+	agc_err_t err = write_all(fd, edges->buf, sizeof(agc_edge_t) * (size_t)edges->len);
+	if (close(fd) != 0 && !err) err = AGC_ERR_IO;
+	return err;
+}
+
+agc_err_t
+agc_stream_partition(agc_stream_shards_t OUT_shards[static 1],
+                     char const         *path,
+                     char const         *prefix,
+                     u32                 n_vertices,
+                     u32                 n_shards)
+{
+	if (!OUT_shards || !path || !prefix) return AGC_ERR_NULL;
+	if (n_vertices == 0 || n_shards == 0 || n_shards > n_vertices) return AGC_ERR_INVALID;
+	agc_err_t err = AGC_OK;
+
+	*OUT_shards = (agc_stream_shards_t){
+		.n_vertices = n_vertices,
+		.n_shards   = n_shards,
+		.interval   = (u32)(((u64)n_vertices + n_shards - 1) / n_shards),
+	};
+
+	u32 flush = agc_max(agc_min(AGC_STREAM_STAGING_EDGES / n_shards, AGC_STREAM_FLUSH_EDGES), 1u);
+
+	int         in_fd    = -1;
+	u64         n_edges  = 0;
+	u32         n_opened = 0;
+	int        *fds      = fds_alloc(n_shards);
+	u32        *fill     = calloc(n_shards, sizeof(u32));
+	agc_edge_t *out      = malloc(sizeof(agc_edge_t) * flush * n_shards);
+	OUT_shards->prefix   = strdup(prefix);
+	if (!fds || !fill || !out || !OUT_shards->prefix)
+	{
+		err = AGC_ERR_MEMORY;
+		goto out;
+	}
+
+	err = agc_u64vec_init(&OUT_shards->n_edges, (int32_t)n_shards);
+	if (err) goto out;
+	err = agc_u64vec_resize(&OUT_shards->n_edges, (int32_t)n_shards);
+	if (err) goto out;
+
+	for (u32 k = 0; k < n_shards; k++)
+	{
+		char *shard = shard_path(prefix, k);
+		if (!shard)
+		{
+			err = AGC_ERR_MEMORY;
+			goto out;
+		}
+		fds[k] = open(shard, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		free(shard);
+		if (fds[k] < 0)
+		{
+			err = AGC_ERR_IO;
+			goto out;
+		}
+		n_opened = k + 1;
+	}
+
+	err = edge_file_open(path, &in_fd, &n_edges);
+	if (err) goto out;
+
+	prefetch_t p;
+	thrd_t     reader;
+	err = prefetch_start(&p, &reader, &in_fd, &n_edges, 1, AGC_STREAM_BATCH_EDGES);
+	if (err) goto out;
+
+	u64 *shard_edges = OUT_shards->n_edges.buf;
+	for (u32 slot = 0;; slot ^= 1)
+	{
+		u32 len = 0;
+		prefetch_wait(&p, slot, &len);
+		if (len == 0) break;
+
+		for (u32 i = 0; i < len; i++)
+		{
+			agc_edge_t e = p.buf[slot][i];
+			if (e.src >= n_vertices || e.dst >= n_vertices)
+			{
+				err = AGC_ERR_OOB;
+				break;
+			}
+
+			u32         k    = e.dst / OUT_shards->interval;
+			agc_edge_t *part = out + (size_t)k * flush;
+			part[fill[k]++]  = e;
+			shard_edges[k]++;
+			if (fill[k] < flush) continue;
+
+			err     = write_all(fds[k], part, sizeof(agc_edge_t) * flush);
+			fill[k] = 0;
+			if (err) break;
+		}
+
+		prefetch_release(&p, slot);
+		if (err) break;
+	}
+
+	agc_err_t read_err = prefetch_finish(&p, reader);
+	if (!err) err = read_err;
+
+	for (u32 k = 0; k < n_shards && !err; k++)
+	{
+		err = write_all(fds[k], out + (size_t)k * flush, sizeof(agc_edge_t) * fill[k]);
+	}
+
+out:
+	if (in_fd >= 0) close(in_fd);
+	agc_err_t close_err = fds_close(fds, n_shards);
+	if (!err) err = close_err;
+	free(fill);
+	free(out);
+	if (err)
+	{
+		if (OUT_shards->prefix) shards_unlink(OUT_shards->prefix, n_opened);
+		agc_stream_shards_cleanup(OUT_shards);
+	}
+	return err;
+}
+
+agc_err_t
+agc_stream_run(const agc_stream_shards_t shards[static 1],
+               const agc_stream_fns_t    fns[static 1],
+               u32                       batch_edges)
+{
+	if (!shards || !fns || !fns->scatter || !fns->gather) return AGC_ERR_NULL;
+	if (!batch_edges) batch_edges = AGC_STREAM_BATCH_EDGES;
+	agc_err_t err = AGC_OK;
+
+	u32  n_shards = shards->n_shards;
+	int *fds      = fds_alloc(n_shards);
+	if (!fds) return AGC_ERR_MEMORY;
+
+	for (u32 k = 0; k < n_shards; k++)
+	{
+		char *path = shard_path(shards->prefix, k);
+		if (!path)
+		{
+			err = AGC_ERR_MEMORY;
+			goto out;
+		}
+		fds[k] = open(path, O_RDONLY);
+		free(path);
+		if (fds[k] < 0)
+		{
+			err = AGC_ERR_IO;
+			goto out;
+		}
+		posix_fadvise(fds[k], 0, 0, POSIX_FADV_SEQUENTIAL);
+	}
+
+	prefetch_t p;
+	thrd_t     reader;
+	err = prefetch_start(&p, &reader, fds, shards->n_edges.buf, n_shards, batch_edges);
+	if (err) goto out;
+
+	/* Shards are finished in order, including the empty ones skipped by
+	 * the reader. */
+	u32 next_done = 0;
+	for (u32 slot = 0;; slot ^= 1)
+	{
+		u32       len      = 0;
+		agc_err_t read_err = prefetch_wait(&p, slot, &len);
+		u32       shard    = p.file[slot];
+		if (len == 0 && read_err) break;
+
+		/* The last shards may be empty when interval does not divide
+		 * n_vertices, they get lo == hi == n_vertices */
+		for (; fns->shard_done && next_done < shard; next_done++)
+		{
+			u64 n  = shards->n_vertices;
+			u32 lo = (u32)agc_min((u64)next_done * shards->interval, n);
+			u32 hi = (u32)agc_min((u64)lo + shards->interval, n);
+			fns->shard_done(next_done, lo, hi, fns->ctx);
+		}
+		if (len == 0) break;
+
+		const agc_edge_t *edges = p.buf[slot];
+		for (u32 i = 0; i < len; i++)
+		{
+			u64 update = 0;
+			if (fns->scatter(&edges[i], &update, fns->ctx))
+				fns->gather(edges[i].dst, update, fns->ctx);
+		}
+
+		prefetch_release(&p, slot);
+	}
+
+	err = prefetch_finish(&p, reader);
+
+out:
+	fds_close(fds, n_shards);
+	return err;
+}
+
+agc_err_t
+agc_stream_shards_remove(const agc_stream_shards_t shards[static 1])
+{
+	if (!shards) return AGC_ERR_NULL;
+	if (!shards->prefix) return AGC_OK;
+
+	return shards_unlink(shards->prefix, shards->n_shards);
+}
+
+void
+agc_stream_shards_cleanup(agc_stream_shards_t shards[static 1])
+{
+	if (!shards) return;
+	agc_u64vec_cleanup(&shards->n_edges);
+	free(shards->prefix);
+	*shards = (agc_stream_shards_t){ };
+}
@@ -0,0 +1,78 @@
+#ifndef AGC_STREAM_H
+#define AGC_STREAM_H
+
+#include "error.h"
+#include "graph.h"
+#include "types.h"
+#include "vectors.h"
+
+/* Out-of-core edge streaming in the style of X-Stream.
+ *
+ * Edge files are raw arrays of agc_edge_t in host byte order. The edges
+ * are first partitioned into shards by destination interval, so that all
+ * updates of a shard land in one contiguous range of vertex state. Each
+ * pass then reads the shards sequentially with large preads, double
+ * buffered by a background thread, while the calling thread runs the
+ * callbacks over the batch already in memory. Only the vertex state has
+ * to fit in RAM. */
+
+#define AGC_STREAM_BATCH_EDGES (1u << 20)
+
+/* Partitioning stages at most AGC_STREAM_FLUSH_EDGES edges per shard and
+ * AGC_STREAM_STAGING_EDGES in total, so many shards get smaller writes
+ * rather than more memory */
+#define AGC_STREAM_FLUSH_EDGES (1u << 12)
+#define AGC_STREAM_STAGING_EDGES (1u << 20)
+
+typedef struct agc_stream_shards_t
+{
+	u32          n_vertices;
+	u32          n_shards;
+	u32          interval; /* Shard k holds dst in [k * interval, (k + 1) * interval) */
+	agc_u64vec_t n_edges;
+	char        *prefix; /* Shard k is stored at "<prefix>.<k>" */
+} agc_stream_shards_t;
+
+typedef struct agc_stream_fns_t
+{
+	/* Reads the source side of edge and, if it returns true, produces an
+	 * update for edge->dst. */
+	bool (*scatter)(const agc_edge_t edge[static 1], u64 OUT_update[static 1], void *ctx);
+	/* Applies an update to the state of dst */
+	void (*gather)(u32 dst, u64 update, void *ctx);
+	/* Called once every edge of [lo, hi) has been gathered, also for empty
+	 * shards. Optional. */
+	void (*shard_done)(u32 shard, u32 lo, u32 hi, void *ctx);
+	void *ctx;
+} agc_stream_fns_t;
+
+/* Writes edges to path as a raw edge file, replacing it */
+agc_err_t
+agc_edge_file_write(char const *path, const agc_edgevec_t edges[static 1]);
+
+/* Splits the edge file at path into n_shards destination intervals of
+ * [0, n_vertices). OUT_shards is initialised by the call. On failure the
+ * shard files this call opened are deleted again. */
+agc_err_t
+agc_stream_partition(agc_stream_shards_t OUT_shards[static 1],
+                     char const         *path,
+                     char const         *prefix,
+                     u32                 n_vertices,
+                     u32                 n_shards);
+
+/* One pass over every edge, shard by shard. Callbacks run on the calling
+ * thread. batch_edges is the size of each of the two read buffers, 0 for
+ * AGC_STREAM_BATCH_EDGES. */
+agc_err_t
+agc_stream_run(const agc_stream_shards_t shards[static 1],
+               const agc_stream_fns_t    fns[static 1],
+               u32                       batch_edges);
+
+/* Deletes the shard files */
+agc_err_t
+agc_stream_shards_remove(const agc_stream_shards_t shards[static 1]);
+
+void
+agc_stream_shards_cleanup(agc_stream_shards_t shards[static 1]);
+
+#endif // !AGC_STREAM_H
@@ -0,0 +1,141 @@
+#include <stdlib.h>
+
+#include "intersect.h"
+#include "triangles.h"
+
+static inline bool
+ranks_before(const agc_csr_t g[static 1], u32 u, u32 v)
+{
+	u32 du = agc_csr_degree(g, u);
+	u32 dv = agc_csr_degree(g, v);
+	return du < dv || (du == dv && u < v);
+}
+
+/* Keeps the u -> v half of every edge where u ranks before v. Adjacency
+ * stays sorted by id, which is all the intersection needs. */
+static agc_err_t
+orient_by_degree(const agc_csr_t g[static 1], u32 **OUT_offsets, u32 **OUT_adj, u32 *OUT_max_deg)
+{
+	u32  n       = g->n_vertices;
+	u32 *offsets = calloc((size_t)n + 1, sizeof(u32));
+	if (!offsets) return AGC_ERR_MEMORY;
+
+	u32 max_deg = 0;
+#pragma omp parallel for schedule(dynamic, 1024) reduction(max : max_deg)
+	for (u32 u = 0; u < n; u++)
+	{
+		const u32 *nbrs = agc_csr_neighbours(g, u);
+		u32        deg  = agc_csr_degree(g, u);
+		u32        out  = 0;
+		for (u32 i = 0; i < deg; i++)
+			out += ranks_before(g, u, nbrs[i]);
+
+		offsets[u + 1] = out;
+		max_deg        = agc_max(max_deg, out);
+	}
+	for (u32 u = 0; u < n; u++)
+		offsets[u + 1] += offsets[u];
+
+	u32 *adj = malloc(sizeof(u32) * agc_max(offsets[n], 1));
+	if (!adj)
+	{
+		free(offsets);
+		return AGC_ERR_MEMORY;
+	}
+
+#pragma omp parallel for schedule(dynamic, 1024)
+	for (u32 u = 0; u < n; u++)
+	{
+		const u32 *nbrs = agc_csr_neighbours(g, u);
+		u32        deg  = agc_csr_degree(g, u);
+		u32        pos  = offsets[u];
+		for (u32 i = 0; i < deg; i++)
+			if (ranks_before(g, u, nbrs[i])) adj[pos++] = nbrs[i];
+	}
+
+	*OUT_offsets = offsets;
+	*OUT_adj     = adj;
+	*OUT_max_deg = max_deg;
+	return AGC_OK;
+}
+
+agc_err_t
+agc_triangle_count(const agc_csr_t g[static 1],
+                   agc_u64vec_t   *OUT_per_vertex,
+                   u64             OUT_total[static 1])
+{
+	if (!g || !OUT_total) return AGC_ERR_NULL;
+	agc_err_t err = AGC_OK;
+
+	u32  n       = g->n_vertices;
+	u32 *offsets = nullptr;
+	u32 *adj     = nullptr;
+	u32  max_deg = 0;
+
+	err = orient_by_degree(g, &offsets, &adj, &max_deg);
+	if (err) return err;
+
+	u64 *per_vertex = nullptr;
+	if (OUT_per_vertex)
+	{
+		err = agc_u64vec_init(OUT_per_vertex, (int32_t)n);
+		if (err) goto out;
+		err = agc_u64vec_resize(OUT_per_vertex, (int32_t)n);
+		if (err) goto fail_per_vertex;
+		per_vertex = OUT_per_vertex->buf;
+	}
+
+	u64  total     = 0;
+	bool alloc_err = false;
+
+#pragma omp parallel reduction(+ : total)
+	{
+		/* Only needed to credit the third vertex of each triangle */
+		u32 *common = per_vertex ? malloc(sizeof(u32) * agc_max(max_deg, 1)) : nullptr;
+		if (per_vertex && !common) __atomic_store_n(&alloc_err, true, __ATOMIC_RELAXED);
+
+#pragma omp for schedule(dynamic, 64)
+		for (u32 u = 0; u < n; u++)
+		{
+			if (per_vertex && !common) continue;
+
+			const u32 *u_adj = adj + offsets[u];
+			u32        u_deg = offsets[u + 1] - offsets[u];
+			u64        u_tri = 0;
+
+			for (u32 i = 0; i < u_deg; i++)
+			{
+				u32 v = u_adj[i];
+				u32 c = agc_intersect_u32(
+				        u_adj, u_deg, adj + offsets[v], offsets[v + 1] - offsets[v], common);
+				u_tri += c;
+				if (!per_vertex || c == 0) continue;
+
+				__atomic_fetch_add(&per_vertex[v], c, __ATOMIC_RELAXED);
+				for (u32 k = 0; k < c; k++)
+					__atomic_fetch_add(&per_vertex[common[k]], 1, __ATOMIC_RELAXED);
+			}
+
+			total += u_tri;
+			if (per_vertex && u_tri) __atomic_fetch_add(&per_vertex[u], u_tri, __ATOMIC_RELAXED);
+		}
+
+		free(common);
+	}
+
+	if (alloc_err)
+	{
+		err = AGC_ERR_MEMORY;
+		goto fail_per_vertex;
+	}
+
+	*OUT_total = total;
+	goto out;
+
+fail_per_vertex:
+	if (OUT_per_vertex) agc_u64vec_cleanup(OUT_per_vertex);
+out:
+	free(offsets);
+	free(adj);
+	return err;
+}
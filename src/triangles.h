@@ -0,0 +1,24 @@
+#ifndef AGC_TRIANGLES_H
+#define AGC_TRIANGLES_H
+
+#include "error.h"
+#include "graph.h"
+#include "types.h"
+#include "vectors.h"
+
+/* Exact triangle count of an undirected, simple CSR graph, i.e. one built
+ * with AGC_CSR_SYMMETRIZE | AGC_CSR_SIMPLE.
+ *
+ * Edges are oriented from lower to higher degree (ties broken by id), so
+ * every triangle is found exactly once by intersecting the oriented
+ * adjacency lists of its lowest-ranked edge. Vertices are processed in
+ * parallel with dynamic scheduling to absorb degree skew.
+ *
+ * OUT_per_vertex may be null; otherwise it is initialised with the number
+ * of triangles every vertex takes part in. */
+agc_err_t
+agc_triangle_count(const agc_csr_t g[static 1],
+                   agc_u64vec_t   *OUT_per_vertex,
+                   u64             OUT_total[static 1]);
+
+#endif // !AGC_TRIANGLES_H
@@ -77,6 +77,14 @@ agc_vec_fn(noop)(T *)
 	#define agc_vec_may_use_element_to_string 0
 #endif
 
+/* Element addition, needed by scatter_add */
+#ifdef agc_vec_implements_element_add
+	#define agc_vec_may_use_element_add 1
+	#define agc_vec_element_add agc_vec_fn(element_add)
+#else
+	#define agc_vec_may_use_element_add 0
+#endif
+
 /* Allocator configuration */
 #ifdef agc_vec_implements_custom_alloc
 	#define agc_vec_alloc agc_vec_fn(alloc)
@@ -101,6 +109,22 @@ agc_vec_fn(noop)(T *)
 	#define AGC_VEC_DEFAULT_CAP 8
 #endif
 
+/* Instrumentation
+ * Defining AGC_VEC_STATS for the whole build makes every namespace count
+ * its allocations and memmoves in relaxed atomics. The counters are weak
+ * symbols, so all translation units instantiating a namespace share
+ * them. Without AGC_VEC_STATS the hooks expand to nothing. */
+#ifdef AGC_VEC_STATS
+	#define agc_vec_stats_counters agc_vec_fn(stats_counters)
+	#define agc_vec_stat_add(field, n)                                                         \
+		__atomic_fetch_add(&agc_vec_stats_counters.field, (uint64_t)(n), __ATOMIC_RELAXED)
+	#define agc_vec_stat_peak(field, v)                                                        \
+		agc_vec_fn(stats_peak)(&agc_vec_stats_counters.field, (uint64_t)(v))
+#else
+	#define agc_vec_stat_add(field, n) ((void)0)
+	#define agc_vec_stat_peak(field, v) ((void)0)
+#endif
+
 // clang-format off
 /* Interface Validation */
 #if (AGC_VEC_GROWTH_FACTOR) < 1
@@ -124,6 +148,10 @@ agc_validate_interface(agc_vec_element_deepcopy, T* (*)(const T *))
 #if agc_vec_may_use_element_compare
 agc_validate_interface(agc_vec_element_compare, int32_t (*)(const T *, const T *))
 #endif
+
+#if agc_vec_may_use_element_add
+agc_validate_interface(agc_vec_element_add, void (*)(T *, const T *))
+#endif
 /* ------------------------------------------------------------------------ */
 
 
@@ -150,6 +178,18 @@ typedef struct agc_vec_t
 #define agc_vec_foreach(vec, element)                                                              \
 	for (auto(element) = (vec)->buf; (element) < (vec)->buf + (vec)->len; ++(element))
 
+#ifdef AGC_VEC_STATS
+[[gnu::weak]] agc_vec_stats_t agc_vec_stats_counters;
+
+AGC_VEC_API void
+agc_vec_fn(stats_peak)(uint64_t *counter, uint64_t value)
+{
+	uint64_t old = __atomic_load_n(counter, __ATOMIC_RELAXED);
+	while (value > old && !__atomic_compare_exchange_n(
+	                              counter, &old, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+#endif
 
 
 AGC_VEC_API agc_err_t 
@@ -263,6 +303,29 @@ agc_vec_fn(get_deepcopy)(const agc_vec_t vec[static 1],
                                                T             **OUT_value);
 #endif
 
+AGC_VEC_API agc_err_t
+agc_vec_fn(gather)(const agc_vec_t vec[static 1],
+                   const uint32_t  idx[],
+                   int32_t         n,
+                   agc_vec_t       out[static 1]);
+
+#if agc_vec_may_use_element_add
+AGC_VEC_API agc_err_t
+agc_vec_fn(scatter_add)(agc_vec_t      vec[static 1],
+                        const uint32_t idx[],
+                        const T        values[],
+                        int32_t        n);
+#endif
+
+AGC_VEC_API void
+agc_vec_fn(stats_snapshot)(agc_vec_stats_t OUT_stats[static 1]);
+
+AGC_VEC_API void
+agc_vec_fn(stats_reset)(void);
+
+AGC_VEC_API void
+agc_vec_fn(stats_write)(FILE *f);
+
 // clang-format on
 
 /* Simple accessors do not return agc_err_t, which is a bit odd,
@@ -313,6 +376,9 @@ agc_vec_fn(init)(agc_vec_t OUT_vec[static 1], int32_t init_cap)
 	T *buf = agc_vec_alloc(sizeof(T) * init_cap);
 	if (!buf) return AGC_ERR_MEMORY;
 
+	agc_vec_stat_add(bytes_allocated, sizeof(T) * init_cap);
+	agc_vec_stat_peak(peak_cap, init_cap);
+
 	OUT_vec->len = 0;
 	OUT_vec->cap = init_cap;
 #if agc_vec_may_use_stack
@@ -366,6 +432,7 @@ AGC_VEC_API agc_err_t
 agc_vec_fn(reserve)(agc_vec_t vec[static 1], int32_t new_cap)
 {
 	if (!vec) return AGC_ERR_NULL;
+	agc_vec_stat_add(reserve_calls, 1);
 	if (new_cap <= vec->cap) return AGC_OK;
 
 #if agc_vec_may_use_stack
@@ -378,6 +445,10 @@ agc_vec_fn(reserve)(agc_vec_t vec[static 1], int32_t new_cap)
 	T *new_buf = agc_vec_realloc(vec->buf, sizeof(T) * new_cap);
 	if (!new_buf) return AGC_ERR_MEMORY;
 
+	agc_vec_stat_add(realloc_calls, 1);
+	agc_vec_stat_add(bytes_allocated, sizeof(T) * new_cap);
+	agc_vec_stat_peak(peak_cap, new_cap);
+
 	vec->buf = new_buf;
 	vec->cap = new_cap;
 	return AGC_OK;
@@ -387,6 +458,7 @@ AGC_VEC_API agc_err_t
 agc_vec_fn(grow)(agc_vec_t vec[static 1], int32_t min_cap)
 {
 	if (!vec) return AGC_ERR_NULL;
+	agc_vec_stat_add(grow_calls, 1);
 	if (min_cap <= vec->cap) return AGC_OK;
 
 	int32_t new_cap   = { };
@@ -438,6 +510,7 @@ AGC_VEC_API agc_err_t
 agc_vec_fn(shrink_to_fit)(agc_vec_t vec[static 1])
 {
 	if (!vec) return AGC_ERR_NULL;
+	agc_vec_stat_add(shrink_calls, 1);
 	if (vec->len == vec->cap) return AGC_OK;
 #if agc_vec_may_use_stack
 	if (vec->stack_buf)
@@ -457,6 +530,7 @@ agc_vec_fn(shrink_to_fit)(agc_vec_t vec[static 1])
 
 	T *new_buf = agc_vec_realloc(vec->buf, sizeof(T) * vec->len);
 	if (!new_buf) return AGC_ERR_MEMORY;
+	agc_vec_stat_add(realloc_calls, 1);
 
 	vec->buf = new_buf;
 	vec->cap = vec->len;
@@ -475,6 +549,7 @@ agc_vec_fn(put_cpy)(agc_vec_t vec[static 1], int32_t pos, T value)
 	if (err) return err;
 
 	memmove(vec->buf + pos + 1, vec->buf + pos, (vec->len - pos) * sizeof(T));
+	agc_vec_stat_add(bytes_moved, (vec->len - pos) * sizeof(T));
 	vec->buf[pos] = value;
 	vec->len++;
 
@@ -493,6 +568,7 @@ agc_vec_fn(put_mv)(agc_vec_t vec[static 1], int32_t pos, T *value)
 	if (err) return err;
 
 	memmove(vec->buf + pos + 1, vec->buf + pos, (vec->len - pos) * sizeof(T));
+	agc_vec_stat_add(bytes_moved, (vec->len - pos) * sizeof(T));
 
 #if agc_vec_may_use_custom_element_move
 	agc_vec_element_move(vec->buf + pos, value);
@@ -529,6 +605,7 @@ agc_vec_fn(array_cpy)(agc_vec_t vec[static 1], int32_t pos, int32_t count, T arr
 	if (err) return err;
 
 	memmove(vec->buf + pos + count, vec->buf + pos, (vec->len - pos) * sizeof(T));
+	agc_vec_stat_add(bytes_moved, (vec->len - pos) * sizeof(T));
 	memcpy(vec->buf + pos, arr, count * sizeof(T));
 	vec->len += count;
 
@@ -547,6 +624,7 @@ agc_vec_fn(array_mv)(agc_vec_t vec[static 1], int32_t pos, T *arr, int32_t count
 	if (err) return err;
 
 	memmove(vec->buf + pos + count, vec->buf + pos, (vec->len - pos) * sizeof(T));
+	agc_vec_stat_add(bytes_moved, (vec->len - pos) * sizeof(T));
 
 #if agc_vec_may_use_custom_element_move
 	for (int32_t i = 0; i < count; i++)
@@ -594,6 +672,7 @@ agc_vec_fn(buf_switch_to_heap)(agc_vec_t vec[static 1])
 	}
 
 	vec->stack_buf = false;
+	agc_vec_stat_add(heap_spills, 1);
 	return err;
 }
 #endif
@@ -614,6 +693,7 @@ agc_vec_fn(pop_at)(agc_vec_t vec[static 1], int32_t pos, T *OUT_value)
 	}
 
 	memmove(vec->buf + pos, vec->buf + pos + 1, (vec->len - pos - 1) * sizeof(T));
+	agc_vec_stat_add(bytes_moved, (vec->len - pos - 1) * sizeof(T));
 	vec->len--;
 
 	return AGC_OK;
@@ -638,6 +718,7 @@ agc_vec_fn(erase_range)(agc_vec_t vec[static 1], int32_t first, int32_t last)
 		agc_vec_element_cleanup(&vec->buf[i]);
 
 	memmove(vec->buf + first, vec->buf + first + count, (vec->len - last) * sizeof(T));
+	agc_vec_stat_add(bytes_moved, (vec->len - last) * sizeof(T));
 	vec->len -= count;
 
 	return AGC_OK;
@@ -740,6 +821,7 @@ agc_vec_fn(merge_subvec)(agc_vec_t  vec[static 1],
 	if (err) return err;
 
 	memmove(subvec->buf + first, subvec->buf + last, (subvec->len - last) * sizeof(T));
+	agc_vec_stat_add(bytes_moved, (subvec->len - last) * sizeof(T));
 	subvec->len -= count;
 
 	return err;
@@ -757,6 +839,102 @@ agc_vec_fn(get_deepcopy)(const agc_vec_t vec[static 1], int32_t pos, T **OUT_val
 }
 #endif
 
+/* Replaces the contents of out with vec[idx[0]], ..., vec[idx[n - 1]].
+ * Stops with AGC_ERR_OOB at the first index out of bounds, out then holds
+ * the elements before it.
+ *
+ * Unlike agc_intern_find_many this does no software prefetching, and so
+ * has no tunable prefetch distance. Both a fixed distance ahead and
+ * group prefetching ran at 0.86x to 1.02x of this plain loop in
+ * bench/gather.c: the loads do not depend on each other, so the core
+ * already overlaps their misses and the prefetches only add work. */
+AGC_VEC_API agc_err_t
+agc_vec_fn(gather)(const agc_vec_t vec[static 1],
+                   const uint32_t  idx[],
+                   int32_t         n,
+                   agc_vec_t       out[static 1])
+{
+	if (!vec || !out || (!idx && n)) return AGC_ERR_NULL;
+	if (n < 0 || vec == out) return AGC_ERR_INVALID;
+	agc_err_t err = AGC_OK;
+
+	if (out->len) agc_vec_fn(clear)(out);
+	err = agc_vec_fn(reserve)(out, n);
+	if (err) return err;
+
+	const T *src = vec->buf;
+	T       *dst = out->buf;
+	uint32_t len = (uint32_t)vec->len;
+	int32_t  i   = 0;
+
+	for (; i < n && idx[i] < len; i++)
+		dst[i] = src[idx[i]];
+
+	out->len = i;
+	return i == n ? AGC_OK : AGC_ERR_OOB;
+}
+
+#if agc_vec_may_use_element_add
+/* vec[idx[i]] += values[i] for i in [0, n), repeated indices accumulate.
+ * All indices are checked before anything is written. There is no
+ * prefetching or prefetch distance here either, for the reason given at
+ * gather. */
+AGC_VEC_API agc_err_t
+agc_vec_fn(scatter_add)(agc_vec_t      vec[static 1],
+                        const uint32_t idx[],
+                        const T        values[],
+                        int32_t        n)
+{
+	if (!vec || ((!idx || !values) && n)) return AGC_ERR_NULL;
+	if (n < 0) return AGC_ERR_INVALID;
+
+	uint32_t len = (uint32_t)vec->len;
+	for (int32_t i = 0; i < n; i++)
+	{
+		if (idx[i] >= len) return AGC_ERR_OOB;
+	}
+
+	T *dst = vec->buf;
+	for (int32_t i = 0; i < n; i++)
+		agc_vec_element_add(dst + idx[i], values + i);
+
+	return AGC_OK;
+}
+#endif
+
+/* Counters are all zero when AGC_VEC_STATS is not defined */
+AGC_VEC_API void
+agc_vec_fn(stats_snapshot)(agc_vec_stats_t OUT_stats[static 1])
+{
+	if (!OUT_stats) return;
+#ifdef AGC_VEC_STATS
+	uint64_t *src = (uint64_t *)&agc_vec_stats_counters;
+	uint64_t *dst = (uint64_t *)OUT_stats;
+	for (size_t i = 0; i < sizeof(agc_vec_stats_t) / sizeof(uint64_t); i++)
+		dst[i] = __atomic_load_n(src + i, __ATOMIC_RELAXED);
+#else
+	*OUT_stats = (agc_vec_stats_t){ };
+#endif
+}
+
+AGC_VEC_API void
+agc_vec_fn(stats_reset)(void)
+{
+#ifdef AGC_VEC_STATS
+	uint64_t *counters = (uint64_t *)&agc_vec_stats_counters;
+	for (size_t i = 0; i < sizeof(agc_vec_stats_t) / sizeof(uint64_t); i++)
+		__atomic_store_n(counters + i, 0, __ATOMIC_RELAXED);
+#endif
+}
+
+AGC_VEC_API void
+agc_vec_fn(stats_write)(FILE *f)
+{
+	agc_vec_stats_t stats = { };
+	agc_vec_fn(stats_snapshot)(&stats);
+	agc_write_vec_stats(agc_stringify(AGC_VEC_NAMESPACE), &stats, f);
+}
+
 /* ---------------------- Vector Interface Cleanup ---------------------- */
 #ifdef AGC_VEC_NAMESPACE
 	#undef AGC_VEC_NAMESPACE
@@ -769,6 +947,16 @@ agc_vec_fn(get_deepcopy)(const agc_vec_t vec[static 1], int32_t pos, T **OUT_val
 	#undef AGC_VEC_DEFAULT_CAP
 #endif
 
+#ifdef agc_vec_stats_counters
+	#undef agc_vec_stats_counters
+#endif
+#ifdef agc_vec_stat_add
+	#undef agc_vec_stat_add
+#endif
+#ifdef agc_vec_stat_peak
+	#undef agc_vec_stat_peak
+#endif
+
 #ifdef agc_vec_element_cleanup
 	#undef agc_vec_element_cleanup
 #endif
@@ -823,6 +1011,16 @@ agc_vec_fn(get_deepcopy)(const agc_vec_t vec[static 1], int32_t pos, T **OUT_val
 	#undef agc_vec_implements_element_to_string
 #endif
 
+#ifdef agc_vec_may_use_element_add
+	#undef agc_vec_may_use_element_add
+#endif
+#ifdef agc_vec_element_add
+	#undef agc_vec_element_add
+#endif
+#ifdef agc_vec_implements_element_add
+	#undef agc_vec_implements_element_add
+#endif
+
 #ifdef agc_vec_alloc
 	#undef agc_vec_alloc
 #endif
@@ -0,0 +1,34 @@
+#ifndef AGC_VECTORS_H
+#define AGC_VECTORS_H
+
+/* Vector instantiations shared by the graph modules.
+ * Include this instead of instantiating vector.h for these element
+ * types again, otherwise the generated functions clash. */
+
+#include "types.h"
+
+static inline void
+agc_u32vec_element_add(u32 *dst, const u32 *src)
+{
+	*dst += *src;
+}
+
+static inline void
+agc_u64vec_element_add(u64 *dst, const u64 *src)
+{
+	*dst += *src;
+}
+
+#define AGC_VEC_NAMESPACE agc_u32vec
+#define T u32
+#define agc_vec_implements_element_add
+#include "vector.h"
+#undef T
+
+#define AGC_VEC_NAMESPACE agc_u64vec
+#define T u64
+#define agc_vec_implements_element_add
+#include "vector.h"
+#undef T
+
+#endif // !AGC_VECTORS_H
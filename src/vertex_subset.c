@@ -0,0 +1,190 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "vertex_subset.h"
+
+agc_err_t
+agc_vertex_subset_init_empty(agc_vertex_subset_t OUT_vs[static 1], u32 n)
+{
+	if (!OUT_vs) return AGC_ERR_NULL;
+
+	*OUT_vs = (agc_vertex_subset_t){ .n = n };
+	return agc_u32vec_init(&OUT_vs->sparse, 0);
+}
+
+agc_err_t
+agc_vertex_subset_init_single(agc_vertex_subset_t OUT_vs[static 1], u32 n, u32 v)
+{
+	if (!OUT_vs) return AGC_ERR_NULL;
+	if (v >= n) return AGC_ERR_OOB;
+
+	agc_err_t err = agc_vertex_subset_init_empty(OUT_vs, n);
+	if (err) return err;
+
+	OUT_vs->sparse.buf[0] = v;
+	OUT_vs->sparse.len    = 1;
+	OUT_vs->size          = 1;
+	return AGC_OK;
+}
+
+agc_err_t
+agc_vertex_subset_init_all(agc_vertex_subset_t OUT_vs[static 1], u32 n)
+{
+	if (!OUT_vs) return AGC_ERR_NULL;
+
+	*OUT_vs = (agc_vertex_subset_t){ .n = n, .size = n, .dense = true };
+
+	agc_err_t err = agc_bitset_init(&OUT_vs->bits, n);
+	if (err) return err;
+
+	agc_bitset_set_all(&OUT_vs->bits);
+	return AGC_OK;
+}
+
+agc_err_t
+agc_vertex_subset_from_sparse(agc_vertex_subset_t OUT_vs[static 1],
+                              u32                 n,
+                              agc_u32vec_t        ids[static 1])
+{
+	if (!OUT_vs || !ids) return AGC_ERR_NULL;
+
+	*OUT_vs = (agc_vertex_subset_t){ .n = n, .size = (u32)ids->len, .sparse = *ids };
+	memset(ids, 0, sizeof(*ids));
+	return AGC_OK;
+}
+
+agc_err_t
+agc_vertex_subset_from_dense(agc_vertex_subset_t OUT_vs[static 1], agc_bitset_t bits[static 1])
+{
+	if (!OUT_vs || !bits) return AGC_ERR_NULL;
+
+	*OUT_vs = (agc_vertex_subset_t){
+		.n     = bits->n_bits,
+		.size  = (u32)agc_bitset_count(bits),
+		.dense = true,
+		.bits  = *bits,
+	};
+	memset(bits, 0, sizeof(*bits));
+	return AGC_OK;
+}
+
+void
+agc_vertex_subset_cleanup(agc_vertex_subset_t vs[static 1])
+{
+	if (!vs) return;
+
+	if (vs->dense) agc_bitset_cleanup(&vs->bits);
+	else agc_u32vec_cleanup(&vs->sparse);
+	vs->size = 0;
+}
+
+agc_err_t
+agc_vertex_subset_to_dense(agc_vertex_subset_t vs[static 1])
+{
+	if (!vs) return AGC_ERR_NULL;
+	if (vs->dense) return AGC_OK;
+
+	agc_err_t err = agc_bitset_from_indices(&vs->bits, vs->n, &vs->sparse);
+	if (err) return err;
+
+	agc_u32vec_cleanup(&vs->sparse);
+	vs->dense = true;
+	return AGC_OK;
+}
+
+agc_err_t
+agc_vertex_subset_to_sparse(agc_vertex_subset_t vs[static 1])
+{
+	if (!vs) return AGC_ERR_NULL;
+	if (!vs->dense) return AGC_OK;
+
+	agc_err_t err = agc_bitset_to_indices(&vs->bits, &vs->sparse);
+	if (err) return err;
+
+	agc_bitset_cleanup(&vs->bits);
+	vs->dense = false;
+	return AGC_OK;
+}
+
+void
+agc_vertex_map(const agc_vertex_subset_t vs[static 1], agc_vertex_fn_t fn, void *ctx)
+{
+	if (!vs || !fn) return;
+
+	if (!vs->dense)
+	{
+#pragma omp parallel for schedule(dynamic, 1024)
+		for (int32_t i = 0; i < vs->sparse.len; i++)
+			fn(vs->sparse.buf[i], ctx);
+		return;
+	}
+
+	u32 n_words = agc_bitset_n_words(vs->n);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (u32 w = 0; w < n_words; w++)
+	{
+		u64 word = vs->bits.words.buf[w];
+		while (word)
+		{
+			fn(w * 64 + (u32)__builtin_ctzll(word), ctx);
+			word &= word - 1;
+		}
+	}
+}
+
+agc_err_t
+agc_vertex_filter(const agc_vertex_subset_t vs[static 1],
+                  agc_vertex_pred_t         pred,
+                  void                     *ctx,
+                  agc_vertex_subset_t       OUT_vs[static 1])
+{
+	if (!vs || !pred || !OUT_vs) return AGC_ERR_NULL;
+	agc_err_t err = AGC_OK;
+
+	if (vs->dense)
+	{
+		agc_bitset_t bits = { };
+		err               = agc_bitset_init(&bits, vs->n);
+		if (err) return err;
+
+		/* Each word is written by the one thread that owns it */
+		u32 n_words = agc_bitset_n_words(vs->n);
+#pragma omp parallel for schedule(dynamic, 64)
+		for (u32 w = 0; w < n_words; w++)
+		{
+			u64 word = vs->bits.words.buf[w];
+			u64 kept = 0;
+			while (word)
+			{
+				u32 bit = (u32)__builtin_ctzll(word);
+				if (pred(w * 64 + bit, ctx)) kept |= 1ull << bit;
+				word &= word - 1;
+			}
+			bits.words.buf[w] = kept;
+		}
+
+		return agc_vertex_subset_from_dense(OUT_vs, &bits);
+	}
+
+	/* Predicates run in parallel into a keep mask, the compaction that
+	 * follows is a cheap sequential pass */
+	int32_t len  = vs->sparse.len;
+	u8     *keep = malloc(agc_max(len, 1));
+	if (!keep) return AGC_ERR_MEMORY;
+
+#pragma omp parallel for schedule(dynamic, 1024)
+	for (int32_t i = 0; i < len; i++)
+		keep[i] = pred(vs->sparse.buf[i], ctx);
+
+	agc_u32vec_t ids = { };
+	err              = agc_u32vec_init(&ids, len);
+	if (!err)
+	{
+		for (int32_t i = 0; i < len; i++)
+			if (keep[i]) ids.buf[ids.len++] = vs->sparse.buf[i];
+		err = agc_vertex_subset_from_sparse(OUT_vs, vs->n, &ids);
+	}
+
+	free(keep);
+	return err;
+}
@@ -0,0 +1,79 @@
+#ifndef AGC_VERTEX_SUBSET_H
+#define AGC_VERTEX_SUBSET_H
+
+#include "bitset.h"
+#include "error.h"
+#include "types.h"
+#include "vectors.h"
+
+/* A set of vertices out of n, stored either sparse as a list of ids or
+ * dense as a bitmap. Small frontiers are cheap to walk as a list, large
+ * ones are cheap to probe as a bitmap; edge_map picks the representation
+ * that suits its direction and converts on demand. Only the active
+ * representation is initialised. */
+typedef struct agc_vertex_subset_t
+{
+	u32          n;
+	u32          size;
+	bool         dense;
+	agc_u32vec_t sparse;
+	agc_bitset_t bits;
+} agc_vertex_subset_t;
+
+agc_err_t
+agc_vertex_subset_init_empty(agc_vertex_subset_t OUT_vs[static 1], u32 n);
+
+agc_err_t
+agc_vertex_subset_init_single(agc_vertex_subset_t OUT_vs[static 1], u32 n, u32 v);
+
+agc_err_t
+agc_vertex_subset_init_all(agc_vertex_subset_t OUT_vs[static 1], u32 n);
+
+/* Takes ownership of ids, which must be distinct and below n */
+agc_err_t
+agc_vertex_subset_from_sparse(agc_vertex_subset_t OUT_vs[static 1],
+                              u32                 n,
+                              agc_u32vec_t        ids[static 1]);
+
+/* Takes ownership of bits, whose size gives n */
+agc_err_t
+agc_vertex_subset_from_dense(agc_vertex_subset_t OUT_vs[static 1], agc_bitset_t bits[static 1]);
+
+void
+agc_vertex_subset_cleanup(agc_vertex_subset_t vs[static 1]);
+
+agc_err_t
+agc_vertex_subset_to_dense(agc_vertex_subset_t vs[static 1]);
+
+/* Sparse ids come out in ascending order */
+agc_err_t
+agc_vertex_subset_to_sparse(agc_vertex_subset_t vs[static 1]);
+
+static inline u32
+agc_vertex_subset_size(const agc_vertex_subset_t vs[static 1])
+{
+	return vs->size;
+}
+
+static inline bool
+agc_vertex_subset_empty(const agc_vertex_subset_t vs[static 1])
+{
+	return vs->size == 0;
+}
+
+typedef void (*agc_vertex_fn_t)(u32 v, void *ctx);
+typedef bool (*agc_vertex_pred_t)(u32 v, void *ctx);
+
+/* Applies fn to every member in parallel */
+void
+agc_vertex_map(const agc_vertex_subset_t vs[static 1], agc_vertex_fn_t fn, void *ctx);
+
+/* Initialises OUT_vs with the members for which pred holds, keeping the
+ * representation of vs */
+agc_err_t
+agc_vertex_filter(const agc_vertex_subset_t vs[static 1],
+                  agc_vertex_pred_t         pred,
+                  void                     *ctx,
+                  agc_vertex_subset_t       OUT_vs[static 1]);
+
+#endif // !AGC_VERTEX_SUBSET_H